@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pegmatite-static.dir/ast.cc.o"
+  "CMakeFiles/pegmatite-static.dir/ast.cc.o.d"
+  "CMakeFiles/pegmatite-static.dir/parser.cc.o"
+  "CMakeFiles/pegmatite-static.dir/parser.cc.o.d"
+  "libpegmatite.a"
+  "libpegmatite.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pegmatite-static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pegmatite.dir/ast.cc.o"
+  "CMakeFiles/pegmatite.dir/ast.cc.o.d"
+  "CMakeFiles/pegmatite.dir/parser.cc.o"
+  "CMakeFiles/pegmatite.dir/parser.cc.o.d"
+  "libpegmatite.pdb"
+  "libpegmatite.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pegmatite.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/arena.dir/arena.cc.o"
+  "CMakeFiles/arena.dir/arena.cc.o.d"
+  "CMakeFiles/arena.dir/benchmark.cc.o"
+  "CMakeFiles/arena.dir/benchmark.cc.o.d"
+  "arena"
+  "arena.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/arena.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/backtracking.dir/backtracking.cc.o"
+  "CMakeFiles/backtracking.dir/backtracking.cc.o.d"
+  "CMakeFiles/backtracking.dir/benchmark.cc.o"
+  "CMakeFiles/backtracking.dir/benchmark.cc.o.d"
+  "backtracking"
+  "backtracking.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/backtracking.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
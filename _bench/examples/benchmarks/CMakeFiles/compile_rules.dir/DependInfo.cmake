@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/_bench/examples/benchmarks/C_parser.cc" "examples/benchmarks/CMakeFiles/compile_rules.dir/C_parser.cc.o" "gcc" "examples/benchmarks/CMakeFiles/compile_rules.dir/C_parser.cc.o.d"
+  "/root/repo/_bench/examples/benchmarks/Calculator_parser.cc" "examples/benchmarks/CMakeFiles/compile_rules.dir/Calculator_parser.cc.o" "gcc" "examples/benchmarks/CMakeFiles/compile_rules.dir/Calculator_parser.cc.o.d"
+  "/root/repo/_bench/examples/benchmarks/JSON_parser.cc" "examples/benchmarks/CMakeFiles/compile_rules.dir/JSON_parser.cc.o" "gcc" "examples/benchmarks/CMakeFiles/compile_rules.dir/JSON_parser.cc.o.d"
+  "/root/repo/examples/benchmarks/benchmark.cc" "examples/benchmarks/CMakeFiles/compile_rules.dir/benchmark.cc.o" "gcc" "examples/benchmarks/CMakeFiles/compile_rules.dir/benchmark.cc.o.d"
+  "/root/repo/examples/benchmarks/compile_rules.cc" "examples/benchmarks/CMakeFiles/compile_rules.dir/compile_rules.cc.o" "gcc" "examples/benchmarks/CMakeFiles/compile_rules.dir/compile_rules.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench/CMakeFiles/pegmatite-static.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
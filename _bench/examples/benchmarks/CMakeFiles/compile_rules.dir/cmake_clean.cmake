@@ -0,0 +1,22 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/compile_rules.dir/C_parser.cc.o"
+  "CMakeFiles/compile_rules.dir/C_parser.cc.o.d"
+  "CMakeFiles/compile_rules.dir/Calculator_parser.cc.o"
+  "CMakeFiles/compile_rules.dir/Calculator_parser.cc.o.d"
+  "CMakeFiles/compile_rules.dir/JSON_parser.cc.o"
+  "CMakeFiles/compile_rules.dir/JSON_parser.cc.o.d"
+  "CMakeFiles/compile_rules.dir/benchmark.cc.o"
+  "CMakeFiles/compile_rules.dir/benchmark.cc.o.d"
+  "CMakeFiles/compile_rules.dir/compile_rules.cc.o"
+  "CMakeFiles/compile_rules.dir/compile_rules.cc.o.d"
+  "C_parser.cc"
+  "Calculator_parser.cc"
+  "JSON_parser.cc"
+  "compile_rules"
+  "compile_rules.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/compile_rules.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
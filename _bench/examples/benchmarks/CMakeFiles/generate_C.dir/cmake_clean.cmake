@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_C.dir/generate_grammar.cc.o"
+  "CMakeFiles/generate_C.dir/generate_grammar.cc.o.d"
+  "generate_C"
+  "generate_C.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_C.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_Calculator.dir/generate_grammar.cc.o"
+  "CMakeFiles/generate_Calculator.dir/generate_grammar.cc.o.d"
+  "generate_Calculator"
+  "generate_Calculator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_Calculator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_JSON.dir/generate_grammar.cc.o"
+  "CMakeFiles/generate_JSON.dir/generate_grammar.cc.o.d"
+  "generate_JSON"
+  "generate_JSON.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_JSON.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
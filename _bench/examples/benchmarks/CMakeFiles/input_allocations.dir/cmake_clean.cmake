@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/input_allocations.dir/benchmark.cc.o"
+  "CMakeFiles/input_allocations.dir/benchmark.cc.o.d"
+  "CMakeFiles/input_allocations.dir/input_allocations.cc.o"
+  "CMakeFiles/input_allocations.dir/input_allocations.cc.o.d"
+  "input_allocations"
+  "input_allocations.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/input_allocations.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
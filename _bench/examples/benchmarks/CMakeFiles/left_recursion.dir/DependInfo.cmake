@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/examples/benchmarks/benchmark.cc" "examples/benchmarks/CMakeFiles/left_recursion.dir/benchmark.cc.o" "gcc" "examples/benchmarks/CMakeFiles/left_recursion.dir/benchmark.cc.o.d"
+  "/root/repo/examples/benchmarks/left_recursion.cc" "examples/benchmarks/CMakeFiles/left_recursion.dir/left_recursion.cc.o" "gcc" "examples/benchmarks/CMakeFiles/left_recursion.dir/left_recursion.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench/CMakeFiles/pegmatite-static.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/left_recursion.dir/benchmark.cc.o"
+  "CMakeFiles/left_recursion.dir/benchmark.cc.o.d"
+  "CMakeFiles/left_recursion.dir/left_recursion.cc.o"
+  "CMakeFiles/left_recursion.dir/left_recursion.cc.o.d"
+  "left_recursion"
+  "left_recursion.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/left_recursion.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
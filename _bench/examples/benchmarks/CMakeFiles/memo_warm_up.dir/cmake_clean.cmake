@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/memo_warm_up.dir/benchmark.cc.o"
+  "CMakeFiles/memo_warm_up.dir/benchmark.cc.o.d"
+  "CMakeFiles/memo_warm_up.dir/memo_warm_up.cc.o"
+  "CMakeFiles/memo_warm_up.dir/memo_warm_up.cc.o.d"
+  "memo_warm_up"
+  "memo_warm_up.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/memo_warm_up.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
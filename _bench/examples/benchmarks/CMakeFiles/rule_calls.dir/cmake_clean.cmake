@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/rule_calls.dir/benchmark.cc.o"
+  "CMakeFiles/rule_calls.dir/benchmark.cc.o.d"
+  "CMakeFiles/rule_calls.dir/rule_calls.cc.o"
+  "CMakeFiles/rule_calls.dir/rule_calls.cc.o.d"
+  "rule_calls"
+  "rule_calls.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/rule_calls.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3340 @@
+// Generated by pegmatite::generateParser().  Do not edit.
+#include "grammars.hh"
+
+using pegmatite::GeneratedContext;
+
+// ws, as a non-terminal.
+static bool rule_0_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	GeneratedContext::Mark m2;
+l0:
+	c.whitespace();
+	m0 = c.mark();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x9) && (ch <= 0xa)) || (ch == 0x20)))
+		{
+			c.mismatch();
+			goto f3;
+		}
+		c.advance();
+	}
+	c.release(m1);
+	goto l17;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l7:
+	if (!c.character(0x2f) ||
+	    !c.character(0x2f))
+	{
+		goto f1;
+	}
+	c.whitespace();
+l9:
+	c.whitespace();
+	m1 = c.mark();
+	m2 = c.mark();
+	if (!c.character(0xa))
+	{
+		goto f11;
+	}
+	c.reset(m2);
+	goto f10;
+l14:
+	c.whitespace();
+	if (!c.any())
+	{
+		goto f10;
+	}
+	c.release(m1);
+	goto l9;
+l17:
+	c.release(m0);
+	goto l0;
+l18:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l18;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l6;
+	}
+	goto f1;
+f10:
+	if (c.reset(m1))
+	{
+		goto l17;
+	}
+	goto f1;
+f11:
+	if (c.reset(m2))
+	{
+		goto l14;
+	}
+	goto f10;
+}
+
+// ws, as a terminal.
+static bool rule_0_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	GeneratedContext::Mark m2;
+l0:
+	m0 = c.mark();
+	switch (c.dispatch(1))
+	{
+	case 0:
+		goto l2;
+	case 1:
+		goto l6;
+	default:
+		goto f0;
+	}
+l2:
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x9) && (ch <= 0xa)) || (ch == 0x20)))
+		{
+			c.mismatch();
+			goto f2;
+		}
+		c.advance();
+	}
+	c.release(m1);
+	goto l13;
+l5:
+	switch (c.dispatch(5))
+	{
+	case 1:
+		goto l6;
+	default:
+		goto f0;
+	}
+l6:
+	if (!c.character(0x2f) ||
+	    !c.character(0x2f))
+	{
+		goto f0;
+	}
+l7:
+	m1 = c.mark();
+	m2 = c.mark();
+	if (!c.character(0xa))
+	{
+		goto f8;
+	}
+	c.reset(m2);
+	goto f7;
+l11:
+	if (!c.any())
+	{
+		goto f7;
+	}
+	c.release(m1);
+	goto l7;
+l13:
+	c.release(m0);
+	goto l0;
+l14:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l14;
+	}
+	return false;
+f2:
+	if (c.reset(m1))
+	{
+		goto l5;
+	}
+	goto f0;
+f7:
+	if (c.reset(m1))
+	{
+		goto l13;
+	}
+	goto f0;
+f8:
+	if (c.reset(m2))
+	{
+		goto l11;
+	}
+	goto f7;
+}
+
+// letter, as a non-terminal.
+static bool rule_1_non_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x41) && (ch <= 0x5a)) || (ch == 0x5f) || ((ch >= 0x61) && (ch <= 0x7a))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	return true;
+}
+
+// letter, as a terminal.
+static bool rule_1_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x41) && (ch <= 0x5a)) || (ch == 0x5f) || ((ch >= 0x61) && (ch <= 0x7a))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	return true;
+}
+
+// ident_char, as a non-terminal.
+static bool rule_2_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// ident_char, as a terminal.
+static bool rule_2_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// keyword, as a non-terminal.
+static bool rule_3_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x66))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l22;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.character(0x65) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l22;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.character(0x77) ||
+	    !c.character(0x68) ||
+	    !c.character(0x69) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x65))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l22;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.character(0x72) ||
+	    !c.character(0x65) ||
+	    !c.character(0x74) ||
+	    !c.character(0x75) ||
+	    !c.character(0x72) ||
+	    !c.character(0x6e))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l22;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l22;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l21:
+	if (!c.character(0x76) ||
+	    !c.character(0x6f) ||
+	    !c.character(0x69) ||
+	    !c.character(0x64))
+	{
+		return false;
+	}
+l22:
+	m0 = c.mark();
+	if (!c.call(23))
+	{
+		goto f22;
+	}
+	c.reset(m0);
+	return false;
+l25:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+f22:
+	if (c.reset(m0))
+	{
+		goto l25;
+	}
+	return false;
+}
+
+// keyword, as a terminal.
+static bool rule_3_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x66))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l22;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.character(0x65) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l22;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.character(0x77) ||
+	    !c.character(0x68) ||
+	    !c.character(0x69) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x65))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l22;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.character(0x72) ||
+	    !c.character(0x65) ||
+	    !c.character(0x74) ||
+	    !c.character(0x75) ||
+	    !c.character(0x72) ||
+	    !c.character(0x6e))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l22;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l22;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l21:
+	if (!c.character(0x76) ||
+	    !c.character(0x6f) ||
+	    !c.character(0x69) ||
+	    !c.character(0x64))
+	{
+		return false;
+	}
+l22:
+	m0 = c.mark();
+	if (!c.call(23))
+	{
+		goto f22;
+	}
+	c.reset(m0);
+	return false;
+l25:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+f22:
+	if (c.reset(m0))
+	{
+		goto l25;
+	}
+	return false;
+}
+
+// ident, as a non-terminal.
+static bool rule_4_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.reset(m0);
+	return false;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	m0 = c.mark();
+	if (!c.call(5))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l4;
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f4:
+	if (c.reset(m0))
+	{
+		goto l7;
+	}
+	return false;
+}
+
+// ident, as a terminal.
+static bool rule_4_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.reset(m0);
+	return false;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	m0 = c.mark();
+	if (!c.call(5))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l4;
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f4:
+	if (c.reset(m0))
+	{
+		goto l7;
+	}
+	return false;
+}
+
+// number, as a non-terminal.
+static bool rule_5_non_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	for (char32_t ch; c.peek(ch) && (((ch >= 0x30) && (ch <= 0x39)));)
+	{
+		c.advance();
+	}
+	c.mismatch();
+	return true;
+}
+
+// number, as a terminal.
+static bool rule_5_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	for (char32_t ch; c.peek(ch) && (((ch >= 0x30) && (ch <= 0x39)));)
+	{
+		c.advance();
+	}
+	c.mismatch();
+	return true;
+}
+
+// call, as a non-terminal.
+static bool rule_6_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(5))
+	{
+		goto f4;
+	}
+	c.whitespace();
+l7:
+	c.whitespace();
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f8;
+	}
+	c.whitespace();
+	if (!c.call(11))
+	{
+		goto f8;
+	}
+	c.release(m1);
+	goto l7;
+l13:
+	c.release(m0);
+	goto l14;
+l14:
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	return true;
+f4:
+	if (c.reset(m0))
+	{
+		goto l14;
+	}
+	return false;
+f8:
+	if (c.reset(m1))
+	{
+		goto l13;
+	}
+	goto f4;
+}
+
+// call, as a terminal.
+static bool rule_6_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.call(3))
+	{
+		goto f2;
+	}
+l4:
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f4;
+	}
+	if (!c.call(6))
+	{
+		goto f4;
+	}
+	c.release(m1);
+	goto l4;
+l8:
+	c.release(m0);
+	goto l9;
+l9:
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l9;
+	}
+	return false;
+f4:
+	if (c.reset(m1))
+	{
+		goto l8;
+	}
+	goto f2;
+}
+
+// primary, as a non-terminal.
+static bool rule_7_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l18;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l18;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l18;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l13:
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(15))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+l18:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+}
+
+// primary, as a terminal.
+static bool rule_7_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l16;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l16;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l16;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	default:
+		return false;
+	}
+l13:
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	if (!c.call(14))
+	{
+		return false;
+	}
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+l16:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+}
+
+// unary, as a non-terminal.
+static bool rule_8_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l12;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x2d))
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l8;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l7:
+	if (!c.character(0x21))
+	{
+		goto f1;
+	}
+l8:
+	c.whitespace();
+	if (!c.call(9))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l13;
+l11:
+	switch (c.dispatch(11))
+	{
+	case 1:
+		goto l12;
+	default:
+		return false;
+	}
+l12:
+	if (!c.call(12))
+	{
+		return false;
+	}
+l13:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l11;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l6;
+	}
+	goto f1;
+}
+
+// unary, as a terminal.
+static bool rule_8_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l11;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x2d))
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l8;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	default:
+		goto f1;
+	}
+l7:
+	if (!c.character(0x21))
+	{
+		goto f1;
+	}
+l8:
+	if (!c.call(8))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l12;
+l10:
+	switch (c.dispatch(10))
+	{
+	case 1:
+		goto l11;
+	default:
+		return false;
+	}
+l11:
+	if (!c.call(11))
+	{
+		return false;
+	}
+l12:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l10;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l6;
+	}
+	goto f1;
+}
+
+// mul_op, as a non-terminal.
+static bool rule_9_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	case 2:
+		goto l11;
+	default:
+		return false;
+	}
+l3:
+	m0 = c.mark();
+	if (!c.character(0x2a))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l12;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	case 2:
+		goto l11;
+	default:
+		return false;
+	}
+l7:
+	m0 = c.mark();
+	if (!c.character(0x2f))
+	{
+		goto f7;
+	}
+	c.release(m0);
+	goto l12;
+l10:
+	switch (c.dispatch(10))
+	{
+	case 2:
+		goto l11;
+	default:
+		return false;
+	}
+l11:
+	if (!c.character(0x25))
+	{
+		return false;
+	}
+l12:
+	c.whitespace();
+	if (!c.call(13))
+	{
+		return false;
+	}
+	return true;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+f7:
+	if (c.reset(m0))
+	{
+		goto l10;
+	}
+	return false;
+}
+
+// mul_op, as a terminal.
+static bool rule_9_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	switch (c.dispatch(1))
+	{
+	case 0:
+		goto l2;
+	case 1:
+		goto l6;
+	case 2:
+		goto l10;
+	default:
+		return false;
+	}
+l2:
+	m0 = c.mark();
+	if (!c.character(0x2a))
+	{
+		goto f2;
+	}
+	c.release(m0);
+	goto l11;
+l5:
+	switch (c.dispatch(5))
+	{
+	case 1:
+		goto l6;
+	case 2:
+		goto l10;
+	default:
+		return false;
+	}
+l6:
+	m0 = c.mark();
+	if (!c.character(0x2f))
+	{
+		goto f6;
+	}
+	c.release(m0);
+	goto l11;
+l9:
+	switch (c.dispatch(9))
+	{
+	case 2:
+		goto l10;
+	default:
+		return false;
+	}
+l10:
+	if (!c.character(0x25))
+	{
+		return false;
+	}
+l11:
+	if (!c.call(11))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l5;
+	}
+	return false;
+f6:
+	if (c.reset(m0))
+	{
+		goto l9;
+	}
+	return false;
+}
+
+// mul, as a non-terminal.
+static bool rule_10_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.call(5))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// mul, as a terminal.
+static bool rule_10_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.call(5))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// add_op, as a non-terminal.
+static bool rule_11_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	default:
+		return false;
+	}
+l3:
+	m0 = c.mark();
+	if (!c.character(0x2b))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l8;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	default:
+		return false;
+	}
+l7:
+	if (!c.character(0x2d))
+	{
+		return false;
+	}
+l8:
+	c.whitespace();
+	if (!c.call(9))
+	{
+		return false;
+	}
+	return true;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// add_op, as a terminal.
+static bool rule_11_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	switch (c.dispatch(1))
+	{
+	case 0:
+		goto l2;
+	case 1:
+		goto l6;
+	default:
+		return false;
+	}
+l2:
+	m0 = c.mark();
+	if (!c.character(0x2b))
+	{
+		goto f2;
+	}
+	c.release(m0);
+	goto l7;
+l5:
+	switch (c.dispatch(5))
+	{
+	case 1:
+		goto l6;
+	default:
+		return false;
+	}
+l6:
+	if (!c.character(0x2d))
+	{
+		return false;
+	}
+l7:
+	if (!c.call(7))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l5;
+	}
+	return false;
+}
+
+// add, as a non-terminal.
+static bool rule_12_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l4;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+}
+
+// add, as a terminal.
+static bool rule_12_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l4;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+}
+
+// cmp_op, as a non-terminal.
+static bool rule_13_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l7;
+	case 2:
+		goto l11;
+	case 3:
+		goto l15;
+	case 4:
+		goto l19;
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l3:
+	m0 = c.mark();
+	if (!c.character(0x3c) ||
+	    !c.character(0x3d))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l24;
+l6:
+	switch (c.dispatch(6))
+	{
+	case 1:
+		goto l7;
+	case 2:
+		goto l11;
+	case 3:
+		goto l15;
+	case 4:
+		goto l19;
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l7:
+	m0 = c.mark();
+	if (!c.character(0x3e) ||
+	    !c.character(0x3d))
+	{
+		goto f7;
+	}
+	c.release(m0);
+	goto l24;
+l10:
+	switch (c.dispatch(10))
+	{
+	case 2:
+		goto l11;
+	case 3:
+		goto l15;
+	case 4:
+		goto l19;
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l11:
+	m0 = c.mark();
+	if (!c.character(0x3d) ||
+	    !c.character(0x3d))
+	{
+		goto f11;
+	}
+	c.release(m0);
+	goto l24;
+l14:
+	switch (c.dispatch(14))
+	{
+	case 3:
+		goto l15;
+	case 4:
+		goto l19;
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l15:
+	m0 = c.mark();
+	if (!c.character(0x21) ||
+	    !c.character(0x3d))
+	{
+		goto f15;
+	}
+	c.release(m0);
+	goto l24;
+l18:
+	switch (c.dispatch(18))
+	{
+	case 4:
+		goto l19;
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l19:
+	m0 = c.mark();
+	if (!c.character(0x3c))
+	{
+		goto f19;
+	}
+	c.release(m0);
+	goto l24;
+l22:
+	switch (c.dispatch(22))
+	{
+	case 5:
+		goto l23;
+	default:
+		return false;
+	}
+l23:
+	if (!c.character(0x3e))
+	{
+		return false;
+	}
+l24:
+	c.whitespace();
+	if (!c.call(25))
+	{
+		return false;
+	}
+	return true;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+f7:
+	if (c.reset(m0))
+	{
+		goto l10;
+	}
+	return false;
+f11:
+	if (c.reset(m0))
+	{
+		goto l14;
+	}
+	return false;
+f15:
+	if (c.reset(m0))
+	{
+		goto l18;
+	}
+	return false;
+f19:
+	if (c.reset(m0))
+	{
+		goto l22;
+	}
+	return false;
+}
+
+// cmp_op, as a terminal.
+static bool rule_13_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	switch (c.dispatch(1))
+	{
+	case 0:
+		goto l2;
+	case 1:
+		goto l6;
+	case 2:
+		goto l10;
+	case 3:
+		goto l14;
+	case 4:
+		goto l18;
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l2:
+	m0 = c.mark();
+	if (!c.character(0x3c) ||
+	    !c.character(0x3d))
+	{
+		goto f2;
+	}
+	c.release(m0);
+	goto l23;
+l5:
+	switch (c.dispatch(5))
+	{
+	case 1:
+		goto l6;
+	case 2:
+		goto l10;
+	case 3:
+		goto l14;
+	case 4:
+		goto l18;
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l6:
+	m0 = c.mark();
+	if (!c.character(0x3e) ||
+	    !c.character(0x3d))
+	{
+		goto f6;
+	}
+	c.release(m0);
+	goto l23;
+l9:
+	switch (c.dispatch(9))
+	{
+	case 2:
+		goto l10;
+	case 3:
+		goto l14;
+	case 4:
+		goto l18;
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l10:
+	m0 = c.mark();
+	if (!c.character(0x3d) ||
+	    !c.character(0x3d))
+	{
+		goto f10;
+	}
+	c.release(m0);
+	goto l23;
+l13:
+	switch (c.dispatch(13))
+	{
+	case 3:
+		goto l14;
+	case 4:
+		goto l18;
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l14:
+	m0 = c.mark();
+	if (!c.character(0x21) ||
+	    !c.character(0x3d))
+	{
+		goto f14;
+	}
+	c.release(m0);
+	goto l23;
+l17:
+	switch (c.dispatch(17))
+	{
+	case 4:
+		goto l18;
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l18:
+	m0 = c.mark();
+	if (!c.character(0x3c))
+	{
+		goto f18;
+	}
+	c.release(m0);
+	goto l23;
+l21:
+	switch (c.dispatch(21))
+	{
+	case 5:
+		goto l22;
+	default:
+		return false;
+	}
+l22:
+	if (!c.character(0x3e))
+	{
+		return false;
+	}
+l23:
+	if (!c.call(23))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l5;
+	}
+	return false;
+f6:
+	if (c.reset(m0))
+	{
+		goto l9;
+	}
+	return false;
+f10:
+	if (c.reset(m0))
+	{
+		goto l13;
+	}
+	return false;
+f14:
+	if (c.reset(m0))
+	{
+		goto l17;
+	}
+	return false;
+f18:
+	if (c.reset(m0))
+	{
+		goto l21;
+	}
+	return false;
+}
+
+// cmp, as a non-terminal.
+static bool rule_14_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l4;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+}
+
+// cmp, as a terminal.
+static bool rule_14_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l4;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+}
+
+// assign, as a non-terminal.
+static bool rule_15_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x3d))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// assign, as a terminal.
+static bool rule_15_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x3d))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// expr, as a non-terminal.
+static bool rule_16_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.call(5))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// expr, as a terminal.
+static bool rule_16_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.call(5))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// block, as a non-terminal.
+static bool rule_17_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x7b))
+	{
+		return false;
+	}
+	c.whitespace();
+l2:
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l2;
+l6:
+	c.whitespace();
+	if (!c.character(0x7d))
+	{
+		return false;
+	}
+	return true;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// block, as a terminal.
+static bool rule_17_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x7b))
+	{
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l1;
+l4:
+	if (!c.character(0x7d))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// if_stmt, as a non-terminal.
+static bool rule_18_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x69) ||
+	    !c.character(0x66))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(8))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.character(0x65) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f10;
+	}
+	c.whitespace();
+	if (!c.call(13))
+	{
+		goto f10;
+	}
+	c.release(m0);
+	goto l15;
+l15:
+	return true;
+f10:
+	if (c.reset(m0))
+	{
+		goto l15;
+	}
+	return false;
+}
+
+// if_stmt, as a terminal.
+static bool rule_18_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x69) ||
+	    !c.character(0x66) ||
+	    !c.character(0x28))
+	{
+		return false;
+	}
+	if (!c.call(1))
+	{
+		return false;
+	}
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	if (!c.call(3))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.character(0x65) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f4;
+	}
+	if (!c.call(6))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l8;
+l8:
+	return true;
+f4:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+}
+
+// while_stmt, as a non-terminal.
+static bool rule_19_non_term(GeneratedContext &c)
+{
+	if (!c.character(0x77) ||
+	    !c.character(0x68) ||
+	    !c.character(0x69) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x65))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(8))
+	{
+		return false;
+	}
+	return true;
+}
+
+// while_stmt, as a terminal.
+static bool rule_19_term(GeneratedContext &c)
+{
+	if (!c.character(0x77) ||
+	    !c.character(0x68) ||
+	    !c.character(0x69) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x65) ||
+	    !c.character(0x28))
+	{
+		return false;
+	}
+	if (!c.call(1))
+	{
+		return false;
+	}
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	if (!c.call(3))
+	{
+		return false;
+	}
+	return true;
+}
+
+// return_stmt, as a non-terminal.
+static bool rule_20_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x72) ||
+	    !c.character(0x65) ||
+	    !c.character(0x74) ||
+	    !c.character(0x75) ||
+	    !c.character(0x72) ||
+	    !c.character(0x6e))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(3))
+	{
+		goto f2;
+	}
+	c.release(m0);
+	goto l5;
+l5:
+	c.whitespace();
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l5;
+	}
+	return false;
+}
+
+// return_stmt, as a terminal.
+static bool rule_20_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x72) ||
+	    !c.character(0x65) ||
+	    !c.character(0x74) ||
+	    !c.character(0x75) ||
+	    !c.character(0x72) ||
+	    !c.character(0x6e))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l4;
+l4:
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// decl, as a non-terminal.
+static bool rule_21_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(2))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.character(0x3d))
+	{
+		goto f4;
+	}
+	c.whitespace();
+	if (!c.call(7))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l9;
+l9:
+	c.whitespace();
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+	return true;
+f4:
+	if (c.reset(m0))
+	{
+		goto l9;
+	}
+	return false;
+}
+
+// decl, as a terminal.
+static bool rule_21_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		return false;
+	}
+	if (!c.call(1))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.character(0x3d))
+	{
+		goto f2;
+	}
+	if (!c.call(4))
+	{
+		goto f2;
+	}
+	c.release(m0);
+	goto l6;
+l6:
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// stmt, as a non-terminal.
+static bool rule_22_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l24;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l24;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l24;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.call(14))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l24;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.call(18))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l24;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l21:
+	if (!c.call(21))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+l24:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+}
+
+// stmt, as a terminal.
+static bool rule_22_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l23;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l23;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l23;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.call(14))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l23;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.call(18))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l23;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	default:
+		return false;
+	}
+l21:
+	if (!c.call(21))
+	{
+		return false;
+	}
+	if (!c.character(0x3b))
+	{
+		return false;
+	}
+l23:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+}
+
+// type, as a non-terminal.
+static bool rule_23_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.character(0x76) ||
+	    !c.character(0x6f) ||
+	    !c.character(0x69) ||
+	    !c.character(0x64))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// type, as a terminal.
+static bool rule_23_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l6;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.character(0x76) ||
+	    !c.character(0x6f) ||
+	    !c.character(0x69) ||
+	    !c.character(0x64))
+	{
+		return false;
+	}
+l6:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// param, as a non-terminal.
+static bool rule_24_non_term(GeneratedContext &c)
+{
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// param, as a terminal.
+static bool rule_24_term(GeneratedContext &c)
+{
+	if (!c.character(0x69) ||
+	    !c.character(0x6e) ||
+	    !c.character(0x74))
+	{
+		return false;
+	}
+	if (!c.call(1))
+	{
+		return false;
+	}
+	return true;
+}
+
+// function, as a non-terminal.
+static bool rule_25_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(2))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(7))
+	{
+		goto f6;
+	}
+	c.whitespace();
+l9:
+	c.whitespace();
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f10;
+	}
+	c.whitespace();
+	if (!c.call(13))
+	{
+		goto f10;
+	}
+	c.release(m1);
+	goto l9;
+l15:
+	c.release(m0);
+	goto l16;
+l16:
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(19))
+	{
+		return false;
+	}
+	return true;
+f6:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f10:
+	if (c.reset(m1))
+	{
+		goto l15;
+	}
+	goto f6;
+}
+
+// function, as a terminal.
+static bool rule_25_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.call(1))
+	{
+		return false;
+	}
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+l5:
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f5;
+	}
+	if (!c.call(7))
+	{
+		goto f5;
+	}
+	c.release(m1);
+	goto l5;
+l9:
+	c.release(m0);
+	goto l10;
+l10:
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+	if (!c.call(11))
+	{
+		return false;
+	}
+	return true;
+f3:
+	if (c.reset(m0))
+	{
+		goto l10;
+	}
+	return false;
+f5:
+	if (c.reset(m1))
+	{
+		goto l9;
+	}
+	goto f3;
+}
+
+// root, as a non-terminal.
+static bool rule_26_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+l0:
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l0;
+l4:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// root, as a terminal.
+static bool rule_26_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+l0:
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l0;
+l3:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+}
+
+bool installCParser(const CGrammar &g)
+{
+	bool ok = true;
+	ok = GeneratedContext::install(g.ws,
+		rule_0_non_term, 0x7f5afa1c94062f0ULL,
+		rule_0_term, 0x7790f2e420b9e0e6ULL) && ok;
+	ok = GeneratedContext::install(g.letter,
+		rule_1_non_term, 0x7f97bfb59acd6d06ULL,
+		rule_1_term, 0x7f97bfb59acd6d06ULL) && ok;
+	ok = GeneratedContext::install(g.ident_char,
+		rule_2_non_term, 0xb561a2dc617af154ULL,
+		rule_2_term, 0xc7e54f749ee9719dULL) && ok;
+	ok = GeneratedContext::install(g.keyword,
+		rule_3_non_term, 0x9fd081df1fff22f9ULL,
+		rule_3_term, 0x9fd081df1fff22f9ULL) && ok;
+	ok = GeneratedContext::install(g.ident,
+		rule_4_non_term, 0x7097a2f949bf39fULL,
+		rule_4_term, 0x7097a2f949bf39fULL) && ok;
+	ok = GeneratedContext::install(g.number,
+		rule_5_non_term, 0xc91c13309ae9a11aULL,
+		rule_5_term, 0xc91c13309ae9a11aULL) && ok;
+	ok = GeneratedContext::install(g.call,
+		rule_6_non_term, 0x23d087e98c10dc5eULL,
+		rule_6_term, 0xef30abd8485c8347ULL) && ok;
+	ok = GeneratedContext::install(g.primary,
+		rule_7_non_term, 0x414587e2791c8b2aULL,
+		rule_7_term, 0xd036322fcfffc1b0ULL) && ok;
+	ok = GeneratedContext::install(g.unary,
+		rule_8_non_term, 0x71574e39d32e6690ULL,
+		rule_8_term, 0x313f5a680cd247b3ULL) && ok;
+	ok = GeneratedContext::install(g.mul_op,
+		rule_9_non_term, 0xa57914429b3b92b3ULL,
+		rule_9_term, 0x7b2500af3a16c3baULL) && ok;
+	ok = GeneratedContext::install(g.mul,
+		rule_10_non_term, 0x204575092a3b6e50ULL,
+		rule_10_term, 0x3577db2543dc61a2ULL) && ok;
+	ok = GeneratedContext::install(g.add_op,
+		rule_11_non_term, 0x2d63caf2024d8a6aULL,
+		rule_11_term, 0x53aca054db31ad42ULL) && ok;
+	ok = GeneratedContext::install(g.add,
+		rule_12_non_term, 0x81f024f4aa5edc42ULL,
+		rule_12_term, 0xe506213c7195faa2ULL) && ok;
+	ok = GeneratedContext::install(g.cmp_op,
+		rule_13_non_term, 0x46d7775e2df427deULL,
+		rule_13_term, 0xa5604d3d47594242ULL) && ok;
+	ok = GeneratedContext::install(g.cmp,
+		rule_14_non_term, 0x81f024f4aa5edc42ULL,
+		rule_14_term, 0xe506213c7195faa2ULL) && ok;
+	ok = GeneratedContext::install(g.assign,
+		rule_15_non_term, 0x198745c69569bed8ULL,
+		rule_15_term, 0x4a8c6b1daa2a97d4ULL) && ok;
+	ok = GeneratedContext::install(g.expr,
+		rule_16_non_term, 0x204575092a3b6e50ULL,
+		rule_16_term, 0x3577db2543dc61a2ULL) && ok;
+	ok = GeneratedContext::install(g.block,
+		rule_17_non_term, 0x23dcbbb4153cb870ULL,
+		rule_17_term, 0x270826645c03b91dULL) && ok;
+	ok = GeneratedContext::install(g.if_stmt,
+		rule_18_non_term, 0x156442ff04f56ba2ULL,
+		rule_18_term, 0x97211056839f8f9eULL) && ok;
+	ok = GeneratedContext::install(g.while_stmt,
+		rule_19_non_term, 0x901ff41b9e0bd0f8ULL,
+		rule_19_term, 0x93834e98b3e016e7ULL) && ok;
+	ok = GeneratedContext::install(g.return_stmt,
+		rule_20_non_term, 0xae2547e57403739cULL,
+		rule_20_term, 0xee809000e35679c7ULL) && ok;
+	ok = GeneratedContext::install(g.decl,
+		rule_21_non_term, 0x1ec30f7c47697b9bULL,
+		rule_21_term, 0xd8e8f1b39d3c7cbfULL) && ok;
+	ok = GeneratedContext::install(g.stmt,
+		rule_22_non_term, 0x6b4abd406894de6eULL,
+		rule_22_term, 0x9d51bd49a203424aULL) && ok;
+	ok = GeneratedContext::install(g.type,
+		rule_23_non_term, 0x948cb44ef53167a0ULL,
+		rule_23_term, 0x948cb44ef53167a0ULL) && ok;
+	ok = GeneratedContext::install(g.param,
+		rule_24_non_term, 0xd6c686911a649b1cULL,
+		rule_24_term, 0xc30ffe4b6c9fa6aULL) && ok;
+	ok = GeneratedContext::install(g.function,
+		rule_25_non_term, 0xf020a79171dd506aULL,
+		rule_25_term, 0xb3bb7c1462fa6cabULL) && ok;
+	ok = GeneratedContext::install(g.root,
+		rule_26_non_term, 0xea7ab770b175881eULL,
+		rule_26_term, 0x36cfa7e11e8a2e51ULL) && ok;
+	return ok;
+}
@@ -0,0 +1,1204 @@
+// Generated by pegmatite::generateParser().  Do not edit.
+#include "grammars.hh"
+
+using pegmatite::GeneratedContext;
+
+// ws, as a non-terminal.
+static bool rule_0_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+l0:
+	c.whitespace();
+	m0 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x9) && (ch <= 0xa)) || (ch == 0xd) || (ch == 0x20)))
+		{
+			c.mismatch();
+			goto f1;
+		}
+		c.advance();
+	}
+	c.release(m0);
+	goto l0;
+l4:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// ws, as a terminal.
+static bool rule_0_term(GeneratedContext &c)
+{
+	for (char32_t ch; c.peek(ch) && (((ch >= 0x9) && (ch <= 0xa)) || (ch == 0xd) || (ch == 0x20));)
+	{
+		c.advance();
+	}
+	c.mismatch();
+	return true;
+}
+
+// digit, as a non-terminal.
+static bool rule_1_non_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	return true;
+}
+
+// digit, as a terminal.
+static bool rule_1_term(GeneratedContext &c)
+{
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !(((ch >= 0x30) && (ch <= 0x39))))
+		{
+			c.mismatch();
+			return false;
+		}
+		c.advance();
+	}
+	return true;
+}
+
+// number, as a non-terminal.
+static bool rule_2_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	m0 = c.mark();
+	if (!c.character(0x2d))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l3;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	m0 = c.mark();
+	if (!c.call(5))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l4;
+l7:
+	m0 = c.mark();
+	if (!c.character(0x2e))
+	{
+		goto f7;
+	}
+	if (!c.call(9))
+	{
+		goto f7;
+	}
+l10:
+	m1 = c.mark();
+	if (!c.call(11))
+	{
+		goto f10;
+	}
+	c.release(m1);
+	goto l10;
+l13:
+	c.release(m0);
+	goto l14;
+l14:
+	m0 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x45) || (ch == 0x65)))
+		{
+			c.mismatch();
+			goto f14;
+		}
+		c.advance();
+	}
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x2b) || (ch == 0x2d)))
+		{
+			c.mismatch();
+			goto f16;
+		}
+		c.advance();
+	}
+	c.release(m1);
+	goto l19;
+l19:
+	if (!c.call(19))
+	{
+		goto f14;
+	}
+l20:
+	m1 = c.mark();
+	if (!c.call(21))
+	{
+		goto f20;
+	}
+	c.release(m1);
+	goto l20;
+l23:
+	c.release(m0);
+	goto l24;
+l24:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f4:
+	if (c.reset(m0))
+	{
+		goto l7;
+	}
+	return false;
+f7:
+	if (c.reset(m0))
+	{
+		goto l14;
+	}
+	return false;
+f10:
+	if (c.reset(m1))
+	{
+		goto l13;
+	}
+	goto f7;
+f14:
+	if (c.reset(m0))
+	{
+		goto l24;
+	}
+	return false;
+f16:
+	if (c.reset(m1))
+	{
+		goto l19;
+	}
+	goto f14;
+f20:
+	if (c.reset(m1))
+	{
+		goto l23;
+	}
+	goto f14;
+}
+
+// number, as a terminal.
+static bool rule_2_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	m0 = c.mark();
+	if (!c.character(0x2d))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l3;
+l3:
+	if (!c.call(3))
+	{
+		return false;
+	}
+l4:
+	m0 = c.mark();
+	if (!c.call(5))
+	{
+		goto f4;
+	}
+	c.release(m0);
+	goto l4;
+l7:
+	m0 = c.mark();
+	if (!c.character(0x2e))
+	{
+		goto f7;
+	}
+	if (!c.call(9))
+	{
+		goto f7;
+	}
+l10:
+	m1 = c.mark();
+	if (!c.call(11))
+	{
+		goto f10;
+	}
+	c.release(m1);
+	goto l10;
+l13:
+	c.release(m0);
+	goto l14;
+l14:
+	m0 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x45) || (ch == 0x65)))
+		{
+			c.mismatch();
+			goto f14;
+		}
+		c.advance();
+	}
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x2b) || (ch == 0x2d)))
+		{
+			c.mismatch();
+			goto f16;
+		}
+		c.advance();
+	}
+	c.release(m1);
+	goto l19;
+l19:
+	if (!c.call(19))
+	{
+		goto f14;
+	}
+l20:
+	m1 = c.mark();
+	if (!c.call(21))
+	{
+		goto f20;
+	}
+	c.release(m1);
+	goto l20;
+l23:
+	c.release(m0);
+	goto l24;
+l24:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f4:
+	if (c.reset(m0))
+	{
+		goto l7;
+	}
+	return false;
+f7:
+	if (c.reset(m0))
+	{
+		goto l14;
+	}
+	return false;
+f10:
+	if (c.reset(m1))
+	{
+		goto l13;
+	}
+	goto f7;
+f14:
+	if (c.reset(m0))
+	{
+		goto l24;
+	}
+	return false;
+f16:
+	if (c.reset(m1))
+	{
+		goto l19;
+	}
+	goto f14;
+f20:
+	if (c.reset(m1))
+	{
+		goto l23;
+	}
+	goto f14;
+}
+
+// str, as a non-terminal.
+static bool rule_3_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x22))
+	{
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l8;
+	default:
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x5c))
+	{
+		goto f3;
+	}
+	if (!c.any())
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l12;
+l7:
+	switch (c.dispatch(7))
+	{
+	case 1:
+		goto l8;
+	default:
+		goto f1;
+	}
+l8:
+	m1 = c.mark();
+	if (!c.character(0x22))
+	{
+		goto f8;
+	}
+	c.reset(m1);
+	goto f1;
+l11:
+	if (!c.any())
+	{
+		goto f1;
+	}
+l12:
+	c.release(m0);
+	goto l1;
+l13:
+	if (!c.character(0x22))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l13;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l7;
+	}
+	goto f1;
+f8:
+	if (c.reset(m1))
+	{
+		goto l11;
+	}
+	goto f1;
+}
+
+// str, as a terminal.
+static bool rule_3_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x22))
+	{
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	switch (c.dispatch(2))
+	{
+	case 0:
+		goto l3;
+	case 1:
+		goto l8;
+	default:
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x5c))
+	{
+		goto f3;
+	}
+	if (!c.any())
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l12;
+l7:
+	switch (c.dispatch(7))
+	{
+	case 1:
+		goto l8;
+	default:
+		goto f1;
+	}
+l8:
+	m1 = c.mark();
+	if (!c.character(0x22))
+	{
+		goto f8;
+	}
+	c.reset(m1);
+	goto f1;
+l11:
+	if (!c.any())
+	{
+		goto f1;
+	}
+l12:
+	c.release(m0);
+	goto l1;
+l13:
+	if (!c.character(0x22))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l13;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l7;
+	}
+	goto f1;
+f8:
+	if (c.reset(m1))
+	{
+		goto l11;
+	}
+	goto f1;
+}
+
+// value, as a non-terminal.
+static bool rule_4_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l26;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l26;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l26;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.call(14))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l26;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.character(0x74) ||
+	    !c.character(0x72) ||
+	    !c.character(0x75) ||
+	    !c.character(0x65))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l26;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l21:
+	m0 = c.mark();
+	if (!c.character(0x66) ||
+	    !c.character(0x61) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f21;
+	}
+	c.release(m0);
+	goto l26;
+l24:
+	switch (c.dispatch(24))
+	{
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l25:
+	if (!c.character(0x6e) ||
+	    !c.character(0x75) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x6c))
+	{
+		return false;
+	}
+l26:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+f21:
+	if (c.reset(m0))
+	{
+		goto l24;
+	}
+	return false;
+}
+
+// value, as a terminal.
+static bool rule_4_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l26;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l5:
+	m0 = c.mark();
+	if (!c.call(6))
+	{
+		goto f5;
+	}
+	c.release(m0);
+	goto l26;
+l8:
+	switch (c.dispatch(8))
+	{
+	case 2:
+		goto l9;
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l9:
+	m0 = c.mark();
+	if (!c.call(10))
+	{
+		goto f9;
+	}
+	c.release(m0);
+	goto l26;
+l12:
+	switch (c.dispatch(12))
+	{
+	case 3:
+		goto l13;
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l13:
+	m0 = c.mark();
+	if (!c.call(14))
+	{
+		goto f13;
+	}
+	c.release(m0);
+	goto l26;
+l16:
+	switch (c.dispatch(16))
+	{
+	case 4:
+		goto l17;
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l17:
+	m0 = c.mark();
+	if (!c.character(0x74) ||
+	    !c.character(0x72) ||
+	    !c.character(0x75) ||
+	    !c.character(0x65))
+	{
+		goto f17;
+	}
+	c.release(m0);
+	goto l26;
+l20:
+	switch (c.dispatch(20))
+	{
+	case 5:
+		goto l21;
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l21:
+	m0 = c.mark();
+	if (!c.character(0x66) ||
+	    !c.character(0x61) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x73) ||
+	    !c.character(0x65))
+	{
+		goto f21;
+	}
+	c.release(m0);
+	goto l26;
+l24:
+	switch (c.dispatch(24))
+	{
+	case 6:
+		goto l25;
+	default:
+		return false;
+	}
+l25:
+	if (!c.character(0x6e) ||
+	    !c.character(0x75) ||
+	    !c.character(0x6c) ||
+	    !c.character(0x6c))
+	{
+		return false;
+	}
+l26:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+f5:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f9:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f13:
+	if (c.reset(m0))
+	{
+		goto l16;
+	}
+	return false;
+f17:
+	if (c.reset(m0))
+	{
+		goto l20;
+	}
+	return false;
+f21:
+	if (c.reset(m0))
+	{
+		goto l24;
+	}
+	return false;
+}
+
+// member, as a non-terminal.
+static bool rule_5_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x3a))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// member, as a terminal.
+static bool rule_5_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x3a))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// object, as a non-terminal.
+static bool rule_6_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x7b))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(3))
+	{
+		goto f2;
+	}
+	c.whitespace();
+l5:
+	c.whitespace();
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f6;
+	}
+	c.whitespace();
+	if (!c.call(9))
+	{
+		goto f6;
+	}
+	c.release(m1);
+	goto l5;
+l11:
+	c.release(m0);
+	goto l12;
+l12:
+	c.whitespace();
+	if (!c.character(0x7d))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f6:
+	if (c.reset(m1))
+	{
+		goto l11;
+	}
+	goto f2;
+}
+
+// object, as a terminal.
+static bool rule_6_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x7b))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f3;
+	}
+	if (!c.call(5))
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l3;
+l7:
+	c.release(m0);
+	goto l8;
+l8:
+	if (!c.character(0x7d))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l7;
+	}
+	goto f1;
+}
+
+// array, as a non-terminal.
+static bool rule_7_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x5b))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.call(3))
+	{
+		goto f2;
+	}
+	c.whitespace();
+l5:
+	c.whitespace();
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f6;
+	}
+	c.whitespace();
+	if (!c.call(9))
+	{
+		goto f6;
+	}
+	c.release(m1);
+	goto l5;
+l11:
+	c.release(m0);
+	goto l12;
+l12:
+	c.whitespace();
+	if (!c.character(0x5d))
+	{
+		return false;
+	}
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f6:
+	if (c.reset(m1))
+	{
+		goto l11;
+	}
+	goto f2;
+}
+
+// array, as a terminal.
+static bool rule_7_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	if (!c.character(0x5b))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+l3:
+	m1 = c.mark();
+	if (!c.character(0x2c))
+	{
+		goto f3;
+	}
+	if (!c.call(5))
+	{
+		goto f3;
+	}
+	c.release(m1);
+	goto l3;
+l7:
+	c.release(m0);
+	goto l8;
+l8:
+	if (!c.character(0x5d))
+	{
+		return false;
+	}
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l8;
+	}
+	return false;
+f3:
+	if (c.reset(m1))
+	{
+		goto l7;
+	}
+	goto f1;
+}
+
+// root, as a non-terminal.
+static bool rule_8_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	return true;
+}
+
+// root, as a terminal.
+static bool rule_8_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	return true;
+}
+
+bool installJSONParser(const JSONGrammar &g)
+{
+	bool ok = true;
+	ok = GeneratedContext::install(g.ws,
+		rule_0_non_term, 0x60253027082cc3faULL,
+		rule_0_term, 0xa00154008e971074ULL) && ok;
+	ok = GeneratedContext::install(g.digit,
+		rule_1_non_term, 0x92f087451c20c1d3ULL,
+		rule_1_term, 0x92f087451c20c1d3ULL) && ok;
+	ok = GeneratedContext::install(g.number,
+		rule_2_non_term, 0xb74f41b179c7a8f3ULL,
+		rule_2_term, 0xb74f41b179c7a8f3ULL) && ok;
+	ok = GeneratedContext::install(g.str,
+		rule_3_non_term, 0xc306f6bcb985fa95ULL,
+		rule_3_term, 0xc306f6bcb985fa95ULL) && ok;
+	ok = GeneratedContext::install(g.value,
+		rule_4_non_term, 0xf7b9ab0be56e175fULL,
+		rule_4_term, 0xe3feb6f9b01dd8ebULL) && ok;
+	ok = GeneratedContext::install(g.member,
+		rule_5_non_term, 0xada5b75aa714a081ULL,
+		rule_5_term, 0x96ee861621db31b1ULL) && ok;
+	ok = GeneratedContext::install(g.object,
+		rule_6_non_term, 0xcdb57f023493d296ULL,
+		rule_6_term, 0xef9f1e8a6339ad81ULL) && ok;
+	ok = GeneratedContext::install(g.array,
+		rule_7_non_term, 0xb2da97f407195b96ULL,
+		rule_7_term, 0x2a5da0cdc7d37d41ULL) && ok;
+	ok = GeneratedContext::install(g.root,
+		rule_8_non_term, 0x4ccb42c24f538c3fULL,
+		rule_8_term, 0x6cf846669af8e560ULL) && ok;
+	return ok;
+}
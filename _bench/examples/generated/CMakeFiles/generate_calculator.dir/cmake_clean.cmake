@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generate_calculator.dir/generate.cc.o"
+  "CMakeFiles/generate_calculator.dir/generate.cc.o.d"
+  "generate_calculator"
+  "generate_calculator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generate_calculator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/examples/generated/calculator.cc" "examples/generated/CMakeFiles/generated_calculator.dir/calculator.cc.o" "gcc" "examples/generated/CMakeFiles/generated_calculator.dir/calculator.cc.o.d"
+  "/root/repo/_bench/examples/generated/calculator_parser.cc" "examples/generated/CMakeFiles/generated_calculator.dir/calculator_parser.cc.o" "gcc" "examples/generated/CMakeFiles/generated_calculator.dir/calculator_parser.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench/CMakeFiles/pegmatite-static.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
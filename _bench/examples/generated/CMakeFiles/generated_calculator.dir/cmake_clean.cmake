@@ -0,0 +1,14 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/generated_calculator.dir/calculator.cc.o"
+  "CMakeFiles/generated_calculator.dir/calculator.cc.o.d"
+  "CMakeFiles/generated_calculator.dir/calculator_parser.cc.o"
+  "CMakeFiles/generated_calculator.dir/calculator_parser.cc.o.d"
+  "calculator_parser.cc"
+  "generated_calculator"
+  "generated_calculator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/generated_calculator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
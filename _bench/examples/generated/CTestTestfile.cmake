@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/examples/generated
+# Build directory: /root/repo/_bench/examples/generated
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(generated_calculator "generated_calculator")
+set_tests_properties(generated_calculator PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/examples/generated/CMakeLists.txt;10;add_test;/root/repo/examples/generated/CMakeLists.txt;0;")
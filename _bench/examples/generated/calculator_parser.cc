@@ -0,0 +1,653 @@
+// Generated by pegmatite::generateParser().  Do not edit.
+#include "calculator.hh"
+
+using pegmatite::GeneratedContext;
+
+// ws, as a non-terminal.
+static bool rule_0_non_term(GeneratedContext &c)
+{
+	if (!c.character(0x20) ||
+	    !c.character(0x9) ||
+	    !c.character(0xa))
+	{
+		return false;
+	}
+	return true;
+}
+
+// ws, as a terminal.
+static bool rule_0_term(GeneratedContext &c)
+{
+	if (!c.character(0x20) ||
+	    !c.character(0x9) ||
+	    !c.character(0xa))
+	{
+		return false;
+	}
+	return true;
+}
+
+// digits, as a non-terminal.
+static bool rule_1_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	return true;
+}
+
+// digits, as a terminal.
+static bool rule_1_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	return true;
+}
+
+// num, as a non-terminal.
+static bool rule_2_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	GeneratedContext::Mark m2;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	m0 = c.mark();
+	if (!c.character(0x2e))
+	{
+		goto f2;
+	}
+	c.whitespace();
+	if (!c.call(5))
+	{
+		goto f2;
+	}
+	c.whitespace();
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x45) || (ch == 0x65)))
+		{
+			c.mismatch();
+			goto f7;
+		}
+		c.advance();
+	}
+	c.whitespace();
+	m2 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x2b) || (ch == 0x2d)))
+		{
+			c.mismatch();
+			goto f10;
+		}
+		c.advance();
+	}
+	c.release(m2);
+	goto l13;
+l13:
+	c.whitespace();
+	if (!c.call(14))
+	{
+		goto f7;
+	}
+	c.release(m1);
+	goto l16;
+l16:
+	c.release(m0);
+	goto l17;
+l17:
+	return true;
+f2:
+	if (c.reset(m0))
+	{
+		goto l17;
+	}
+	return false;
+f7:
+	if (c.reset(m1))
+	{
+		goto l16;
+	}
+	goto f2;
+f10:
+	if (c.reset(m2))
+	{
+		goto l13;
+	}
+	goto f7;
+}
+
+// num, as a terminal.
+static bool rule_2_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	GeneratedContext::Mark m1;
+	GeneratedContext::Mark m2;
+	if (!c.call(0))
+	{
+		return false;
+	}
+	m0 = c.mark();
+	if (!c.character(0x2e))
+	{
+		goto f1;
+	}
+	if (!c.call(3))
+	{
+		goto f1;
+	}
+	m1 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x45) || (ch == 0x65)))
+		{
+			c.mismatch();
+			goto f4;
+		}
+		c.advance();
+	}
+	m2 = c.mark();
+	{
+		char32_t ch;
+		if (!c.peek(ch) || !((ch == 0x2b) || (ch == 0x2d)))
+		{
+			c.mismatch();
+			goto f6;
+		}
+		c.advance();
+	}
+	c.release(m2);
+	goto l9;
+l9:
+	if (!c.call(9))
+	{
+		goto f4;
+	}
+	c.release(m1);
+	goto l11;
+l11:
+	c.release(m0);
+	goto l12;
+l12:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l12;
+	}
+	return false;
+f4:
+	if (c.reset(m1))
+	{
+		goto l11;
+	}
+	goto f1;
+f6:
+	if (c.reset(m2))
+	{
+		goto l9;
+	}
+	goto f4;
+}
+
+// val, as a non-terminal.
+static bool rule_3_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l10;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(7))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+l10:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// val, as a terminal.
+static bool rule_3_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	switch (c.dispatch(0))
+	{
+	case 0:
+		goto l1;
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l1:
+	m0 = c.mark();
+	if (!c.call(2))
+	{
+		goto f1;
+	}
+	c.release(m0);
+	goto l8;
+l4:
+	switch (c.dispatch(4))
+	{
+	case 1:
+		goto l5;
+	default:
+		return false;
+	}
+l5:
+	if (!c.character(0x28))
+	{
+		return false;
+	}
+	if (!c.call(6))
+	{
+		return false;
+	}
+	if (!c.character(0x29))
+	{
+		return false;
+	}
+l8:
+	return true;
+f1:
+	if (c.reset(m0))
+	{
+		goto l4;
+	}
+	return false;
+}
+
+// mul_op, as a non-terminal.
+static bool rule_4_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x2a))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// mul_op, as a terminal.
+static bool rule_4_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x2a))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// div_op, as a non-terminal.
+static bool rule_5_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x2f))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// div_op, as a terminal.
+static bool rule_5_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x2f))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// mul, as a non-terminal.
+static bool rule_6_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l7;
+l3:
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l7;
+l6:
+	if (!c.call(6))
+	{
+		return false;
+	}
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// mul, as a terminal.
+static bool rule_6_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l7;
+l3:
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l7;
+l6:
+	if (!c.call(6))
+	{
+		return false;
+	}
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// add_op, as a non-terminal.
+static bool rule_7_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x2b))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// add_op, as a terminal.
+static bool rule_7_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x2b))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// sub_op, as a non-terminal.
+static bool rule_8_non_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.character(0x2d))
+	{
+		return false;
+	}
+	c.whitespace();
+	if (!c.call(4))
+	{
+		return false;
+	}
+	return true;
+}
+
+// sub_op, as a terminal.
+static bool rule_8_term(GeneratedContext &c)
+{
+	if (!c.call(0))
+	{
+		return false;
+	}
+	if (!c.character(0x2d))
+	{
+		return false;
+	}
+	if (!c.call(2))
+	{
+		return false;
+	}
+	return true;
+}
+
+// expr, as a non-terminal.
+static bool rule_9_non_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l7;
+l3:
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l7;
+l6:
+	if (!c.call(6))
+	{
+		return false;
+	}
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+// expr, as a terminal.
+static bool rule_9_term(GeneratedContext &c)
+{
+	GeneratedContext::Mark m0;
+	m0 = c.mark();
+	if (!c.call(1))
+	{
+		goto f0;
+	}
+	c.release(m0);
+	goto l7;
+l3:
+	m0 = c.mark();
+	if (!c.call(4))
+	{
+		goto f3;
+	}
+	c.release(m0);
+	goto l7;
+l6:
+	if (!c.call(6))
+	{
+		return false;
+	}
+l7:
+	return true;
+f0:
+	if (c.reset(m0))
+	{
+		goto l3;
+	}
+	return false;
+f3:
+	if (c.reset(m0))
+	{
+		goto l6;
+	}
+	return false;
+}
+
+bool installCalculatorParser(const CalculatorGrammar &g)
+{
+	bool ok = true;
+	ok = GeneratedContext::install(g.ws,
+		rule_0_non_term, 0xdf93b0b6c750fee3ULL,
+		rule_0_term, 0xdf93b0b6c750fee3ULL) && ok;
+	ok = GeneratedContext::install(g.digits,
+		rule_1_non_term, 0xcf2f26ef12ea1f1ULL,
+		rule_1_term, 0x2d7d4655eef55e02ULL) && ok;
+	ok = GeneratedContext::install(g.num,
+		rule_2_non_term, 0x6642df21998dd7a0ULL,
+		rule_2_term, 0xfba02755123273f6ULL) && ok;
+	ok = GeneratedContext::install(g.val,
+		rule_3_non_term, 0x5a6cca60aeb9000bULL,
+		rule_3_term, 0x6b340375b6c27ffULL) && ok;
+	ok = GeneratedContext::install(g.mul_op,
+		rule_4_non_term, 0x260afffc3f56911ULL,
+		rule_4_term, 0x624978bdf72e3d01ULL) && ok;
+	ok = GeneratedContext::install(g.div_op,
+		rule_5_non_term, 0xc31d1029d21ab962ULL,
+		rule_5_term, 0x7bd2ff4f2b5a9e7eULL) && ok;
+	ok = GeneratedContext::install(g.mul,
+		rule_6_non_term, 0x7436419b0cd858a4ULL,
+		rule_6_term, 0xd04d861a540ca603ULL) && ok;
+	ok = GeneratedContext::install(g.add_op,
+		rule_7_non_term, 0xeab7ba99da96a4eULL,
+		rule_7_term, 0xaf25ebb66f46c8a2ULL) && ok;
+	ok = GeneratedContext::install(g.sub_op,
+		rule_8_non_term, 0x6e423e6bb24a8768ULL,
+		rule_8_term, 0x150dddc57ec4d8e4ULL) && ok;
+	ok = GeneratedContext::install(g.expr,
+		rule_9_non_term, 0x7436419b0cd858a4ULL,
+		rule_9_term, 0xd04d861a540ca603ULL) && ok;
+	return ok;
+}
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/input_windows.dir/input_windows.cc.o"
+  "CMakeFiles/input_windows.dir/input_windows.cc.o.d"
+  "input_windows"
+  "input_windows.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/input_windows.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -44,6 +44,34 @@ __thread pegmatite::ASTContainer *current = 0;
  * parents.
  */
 __thread pegmatite::ASTParserDelegate *currentParserDelegate;
+/**
+ * The arena from which AST nodes are allocated, or null for the heap.  This
+ * is set for the duration of a parse.
+ */
+__thread pegmatite::Arena *currentArena = 0;
+
+/**
+ * The space before each AST node, used to record the arena that it was
+ * allocated from.  This is rounded up so that the node is suitably aligned.
+ */
+const size_t nodeHeaderSize = alignof(std::max_align_t) > sizeof(void*) ?
+	alignof(std::max_align_t) : sizeof(void*);
+
+/**
+ * Sets the arena for AST nodes, restoring the previous one when destroyed.
+ */
+struct ArenaScope
+{
+	pegmatite::Arena *outer;
+	ArenaScope(pegmatite::Arena *a) : outer(currentArena)
+	{
+		currentArena = a;
+	}
+	~ArenaScope()
+	{
+		currentArena = outer;
+	}
+};
 }
 
 namespace pegmatite {
@@ -56,10 +84,38 @@ ASTNode::~ASTNode()
 {
 }
 
+void *ASTNode::operator new(size_t size)
+{
+	Arena *a = currentArena;
+	char *p = static_cast<char*>(a ? a->allocate(size + nodeHeaderSize) :
+	                                 ::operator new(size + nodeHeaderSize));
+	*reinterpret_cast<Arena**>(p) = a;
+	return p + nodeHeaderSize;
+}
+
+void ASTNode::operator delete(void *p)
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+	char *base = static_cast<char*>(p) - nodeHeaderSize;
+	if (*reinterpret_cast<Arena**>(base) == nullptr)
+	{
+		::operator delete(base);
+	}
+}
+
+Arena *currentASTArena()
+{
+	return currentArena;
+}
+
 
 /** sets the container under construction to be this.
  */
-ASTContainer::ASTContainer()
+ASTContainer::ASTContainer() :
+	members(ArenaAllocator<ASTMember *>(currentArena))
 {
 	current = this;
 }
@@ -79,7 +135,7 @@ void ASTContainer::construct(const InputRange &r, ASTStack &st)
 	}
 	// We don't need the members vector anymore, so clean up the storage it
 	// uses.
-	ASTMember_vector().swap(members);
+	ASTMember_vector(members.get_allocator()).swap(members);
 }
 
 ASTMember::ASTMember()
@@ -122,8 +178,18 @@ parse_proc ASTParserDelegate::get_parse_proc(const Rule &r) const
 std::unique_ptr<ASTNode> parse(Input &input, const Rule &g, const Rule &ws,
                                ErrorList &el, const ParserDelegate &d)
 {
-	ASTStack st;
-	if (!parse(input, g, ws, el, d, &st)) return 0;
+	return parse(input, g, ws, el, d, ParseOptions());
+}
+
+std::unique_ptr<ASTNode> parse(Input &input, const Rule &g, const Rule &ws,
+                               ErrorList &el, const ParserDelegate &d,
+                               const ParseOptions &o)
+{
+	// The nodes created by the parse procedures are allocated from the arena
+	ArenaScope scope(o.arena);
+	ASTStack st(ArenaAllocator<ASTStackEntry>(o.arena));
+	ParseStatistics statistics;
+	if (!parse(input, g, ws, el, d, &st, o, statistics)) return 0;
 	if (st.size() > 1)
 	{
 		int i = 0;
@@ -64,7 +64,14 @@ template <class T> class BindAST;
 typedef std::pair<const InputRange, std::unique_ptr<ASTNode>> ASTStackEntry;
 /** type of AST node stack.
  */
-typedef std::vector<ASTStackEntry> ASTStack;
+typedef std::vector<ASTStackEntry, ArenaAllocator<ASTStackEntry>> ASTStack;
+
+/**
+ * Returns the arena from which AST nodes are currently being allocated, or
+ * null if they are allocated from the heap.  While parsing into an AST, this
+ * is the arena specified in the `ParseOptions`, if any.
+ */
+Arena *currentASTArena();
 
 #ifdef USE_RTTI
 #define PEGMATITE_RTTI(thisclass, superclass)
@@ -112,6 +119,26 @@ public:
 	 * unit that includes this header.
 	 */
 	virtual ~ASTNode();
+
+	/**
+	 * Allocates AST nodes from the current arena (see `currentASTArena()`),
+	 * or from the heap if there isn't one.
+	 */
+	static void *operator new(size_t size);
+	/**
+	 * Frees an AST node.  Nodes that were allocated from an arena are freed
+	 * when the arena is reset.
+	 */
+	static void operator delete(void *p);
+	/**
+	 * Placement new, which would otherwise be hidden by the class-specific
+	 * `operator new`.
+	 */
+	static void *operator new(size_t, void *p) noexcept { return p; }
+	/**
+	 * Placement delete, matching placement new.
+	 */
+	static void operator delete(void *, void *) noexcept {}
 	
 	/**
 	 * Returns the parent of this AST node, or `nullptr` if there isn't one
@@ -228,7 +255,7 @@ private:
 	/**
 	 * The type used for tracking the fields of subclasses.
 	 */
-	typedef std::vector<ASTMember *> ASTMember_vector;
+	typedef std::vector<ASTMember *, ArenaAllocator<ASTMember *>> ASTMember_vector;
 	/**
 	 * References to all of the fields of the subclass that will be
 	 * automatically constructed.
@@ -373,10 +400,12 @@ template <class T> class ASTList : public ASTMember
 {
 public:
 	///list type.
-	typedef std::list<std::unique_ptr<T>> container;
+	typedef std::list<std::unique_ptr<T>, ArenaAllocator<std::unique_ptr<T>>>
+		container;
 
 	///the default constructor.
-	ASTList() {}
+	ASTList() :
+		child_objects(ArenaAllocator<std::unique_ptr<T>>(currentASTArena())) {}
 
 	/** duplicates the objects of the given list.
 		@param src source object.
@@ -474,6 +503,16 @@ private:
 std::unique_ptr<ASTNode> parse(Input &i, const Rule &g, const Rule &ws,
                                ErrorList &el, const ParserDelegate &d);
 
+/** parses the given input with the specified options.  If the options
+	specify an arena, then the AST is allocated from it and must be destroyed
+	before the arena is reset.
+	@param o the options for this parse.
+	@return pointer to ast node created, or null if there was an error.
+ */
+std::unique_ptr<ASTNode> parse(Input &i, const Rule &g, const Rule &ws,
+                               ErrorList &el, const ParserDelegate &d,
+                               const ParseOptions &o);
+
 /**
  * A parser delegate that is responsible for creating AST nodes from the input.
  *
@@ -527,7 +566,18 @@ class ASTParserDelegate : ParserDelegate
 	template <class T> bool parse(Input &i, const Rule &g, const Rule &ws,
 	                              ErrorList &el, std::unique_ptr<T> &ast) const
 	{
-		std::unique_ptr<ASTNode> node = pegmatite::parse(i, g, ws, el, *this);
+		return parse(i, g, ws, el, ast, ParseOptions());
+	}
+	/**
+	 * Parse an input `i` with the options `o`.  This is identical to the
+	 * version without the `o` parameter, except that if the options specify
+	 * an arena then the AST is allocated from it.
+	 */
+	template <class T> bool parse(Input &i, const Rule &g, const Rule &ws,
+	                              ErrorList &el, std::unique_ptr<T> &ast,
+	                              const ParseOptions &o) const
+	{
+		std::unique_ptr<ASTNode> node = pegmatite::parse(i, g, ws, el, *this, o);
 		T *n = node->get_as<T>();
 		if (n)
 		{
@@ -0,0 +1,175 @@
+/**
+ * Compares building an AST with the nodes and the parser's tables allocated
+ * from the heap against allocating them from an arena.  The input is an
+ * arithmetic expression with a few thousand terms, parsed repeatedly, and
+ * the results are the number of calls to the global `operator new` and the
+ * time for each parse once the tables have reached their full size.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * A left-associative grammar for sums of products.
+ */
+struct SumGrammar
+{
+	Rule ws     = " \t\n"_E;
+	Rule num    = term(+range('0', '9'));
+	Rule mul_op = mul >> '*' >> num;
+	Rule mul    = mul_op | num;
+	Rule add_op = expr >> '+' >> mul;
+	Rule expr   = add_op | mul;
+
+	/**
+	 * Returns the instance of the grammar.
+	 */
+	static const SumGrammar &get()
+	{
+		static SumGrammar g;
+		return g;
+	}
+};
+
+/**
+ * The base class for expressions.
+ */
+class Expression : public ASTContainer
+{
+public:
+	/**
+	 * Returns the value of the expression.
+	 */
+	virtual long eval() const = 0;
+	PEGMATITE_RTTI(Expression, ASTContainer);
+};
+
+/**
+ * A number.  The value is read without allocating, so that the only
+ * allocations made are those of the AST and the parser.
+ */
+class Number : public Expression
+{
+public:
+	virtual void construct(const InputRange &r, ASTStack &)
+	{
+		value = 0;
+		for (char32_t c : r)
+		{
+			value = value * 10 + (c - '0');
+		}
+	}
+	virtual long eval() const
+	{
+		return value;
+	}
+private:
+	long value;
+};
+
+/**
+ * The sum of two expressions.
+ */
+class Add : public Expression
+{
+	ASTPtr<Expression> left, right;
+public:
+	virtual long eval() const
+	{
+		return left->eval() + right->eval();
+	}
+};
+
+/**
+ * The product of two expressions.
+ */
+class Multiply : public Expression
+{
+	ASTPtr<Expression> left, right;
+public:
+	virtual long eval() const
+	{
+		return left->eval() * right->eval();
+	}
+};
+
+/**
+ * Builds the AST for the grammar.
+ */
+class SumParser : public ASTParserDelegate
+{
+	BindAST<Number> num = SumGrammar::get().num;
+	BindAST<Add> add = SumGrammar::get().add_op;
+	BindAST<Multiply> mul = SumGrammar::get().mul_op;
+};
+
+/**
+ * The number of parses timed in each run.
+ */
+const int parses = 20;
+
+/**
+ * Parses `text` into an AST, from `arena` if it is not null, and prints the
+ * allocations and time per parse.
+ */
+void measure(const char *name, const std::string &text, Arena *arena)
+{
+	const SumGrammar &g = SumGrammar::get();
+	SumParser parser;
+	StringViewInput input(text);
+	ParseOptions options;
+	options.arena = arena;
+	long result = 0;
+	auto parseOnce = [&]()
+		{
+			ErrorList errors;
+			std::unique_ptr<Expression> ast;
+			bool ok = parser.parse(input, g.expr, g.ws, errors, ast, options);
+			result = ok ? ast->eval() : -1;
+			ast.reset();
+			if (arena)
+			{
+				arena->reset();
+			}
+		};
+	// Let the parser's tables and the arena reach their full size.
+	parseOnce();
+	parseOnce();
+	uint64_t allocations = benchmark::allocationCount();
+	uint64_t bytes = benchmark::allocatedBytes();
+	parseOnce();
+	allocations = benchmark::allocationCount() - allocations;
+	bytes = benchmark::allocatedBytes() - bytes;
+	double time = benchmark::bestTime(5, [&]()
+		{
+			for (int i=0 ; i<parses ; i++)
+			{
+				parseOnce();
+			}
+		});
+	printf("%-8s %12llu %12llu %12.2f %12ld\n", name,
+	       static_cast<unsigned long long>(allocations),
+	       static_cast<unsigned long long>(bytes), time / parses, result);
+}
+}
+
+int main()
+{
+	std::string text = "1";
+	for (int i=2 ; i<=4000 ; i++)
+	{
+		text += (i % 3 == 0) ? "*" : "+";
+		text += std::to_string(i % 100);
+	}
+	printf("%-8s %12s %12s %12s %12s\n", "", "allocations", "bytes",
+	       "ms/parse", "result");
+	measure("heap", text, nullptr);
+	Arena arena;
+	measure("arena", text, &arena);
+	return 0;
+}
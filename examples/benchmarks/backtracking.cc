@@ -0,0 +1,88 @@
+/**
+ * Compares the work done by the parser with and without memoizing failed
+ * rules, on a grammar whose alternatives share a prefix that fails.
+ *
+ * Each level of the grammar tries the next level twice, once before each of
+ * two different characters.  When neither character follows, the level fails,
+ * and so does the level above it, after trying it twice.  Without failures in
+ * the memo table, the innermost level is tried 2^depth times; with them, each
+ * level is parsed once per position.
+ */
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+//the number of levels in the grammar
+const int depth = 16;
+
+/**
+ * A grammar in which `levels[i]` is `levels[i+1] 'a' | levels[i+1] 'b'` and
+ * the innermost level is `'x'`.  An item is either a match for the outermost
+ * level or `x` followed by any other letter, so every item that isn't the
+ * former makes the parser fail through every level first.
+ */
+struct BacktrackingGrammar
+{
+	Rule ws = " \t\n"_S;
+	std::vector<std::unique_ptr<Rule>> levels;
+	std::unique_ptr<Rule> item;
+	std::unique_ptr<Rule> items;
+	BacktrackingGrammar()
+	{
+		levels.resize(depth + 1);
+		levels[depth].reset(new Rule('x'_E));
+		for (int i=depth-1 ; i>=0 ; i--)
+		{
+			const Rule &next = *levels[i+1];
+			levels[i].reset(new Rule((next >> 'a') | (next >> 'b')));
+		}
+		for (auto &level : levels)
+		{
+			level->setMemoPolicy(MEMO_ALWAYS);
+		}
+		item.reset(new Rule(*levels[0] | ('x'_E >> ('a'_E - 'z'))));
+		items.reset(new Rule(*ExprPtr(*item)));
+	}
+};
+}
+
+int main()
+{
+	BacktrackingGrammar g;
+	// Most items fail through every level; one in eight matches them all.
+	std::string text;
+	for (int i=0 ; i<200 ; i++)
+	{
+		text += (i % 8 == 0) ? "x" + std::string(depth, 'a') + " " : "xq ";
+	}
+	StringViewInput input(text);
+	benchmark::NoActions delegate;
+
+	printf("%d levels, %zu bytes of input\n\n", depth, text.size());
+	printf("%-20s %12s %14s %10s\n", "failures memoized", "rule parses",
+	       "failure hits", "time (ms)");
+	for (bool memoize : { false, true })
+	{
+		ParseOptions options;
+		options.memoize_failures = memoize;
+		ParseStatistics statistics;
+		bool ok = true;
+		double time = benchmark::bestTime(5, [&]()
+			{
+				ErrorList errors;
+				ok &= parse(input, *g.items, g.ws, errors, delegate, nullptr,
+				            options, statistics);
+			});
+		printf("%-20s %12llu %14llu %10.2f%s\n", memoize ? "yes" : "no",
+		       (unsigned long long)statistics.rule_parses,
+		       (unsigned long long)statistics.memo_failure_hits, time,
+		       ok ? "" : "  (parse failed)");
+	}
+	return 0;
+}
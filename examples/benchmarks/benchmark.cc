@@ -0,0 +1,51 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "benchmark.hh"
+
+namespace
+{
+//the number of calls to the global operator new
+std::atomic<uint64_t> allocations(0);
+//the number of bytes requested from operator new
+std::atomic<uint64_t> bytes(0);
+}
+
+namespace benchmark
+{
+uint64_t allocationCount()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+uint64_t allocatedBytes()
+{
+	return bytes.load(std::memory_order_relaxed);
+}
+}
+
+void *operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+	void *p = malloc(size ? size : 1);
+	if (p == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void *operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+	free(p);
+}
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdint>
+#include "pegmatite.hh"
+
+/**
+ * Helpers shared by the benchmark programs.
+ */
+namespace benchmark
+{
+/**
+ * Returns the number of calls to the global `operator new` since the program
+ * started.  Every benchmark program links in benchmark.cc, which replaces the
+ * global allocation functions to count them.
+ */
+uint64_t allocationCount();
+/**
+ * Returns the number of bytes requested from the global `operator new` since
+ * the program started.
+ */
+uint64_t allocatedBytes();
+
+/**
+ * Calls `f` `runs` times and returns the shortest time taken by one call, in
+ * milliseconds.  The shortest time is the least affected by other activity on
+ * the machine.
+ */
+template<typename F>
+double bestTime(int runs, F f)
+{
+	double best = 0;
+	for (int i=0 ; i<runs ; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double, std::milli> time =
+			std::chrono::steady_clock::now() - start;
+		if ((i == 0) || (time.count() < best))
+		{
+			best = time.count();
+		}
+	}
+	return best;
+}
+
+/**
+ * A delegate that attaches no actions to any rule, so that a benchmark
+ * measures only the parser.
+ */
+struct NoActions : public pegmatite::ParserDelegate
+{
+	pegmatite::parse_proc get_parse_proc(const pegmatite::Rule &) const override
+	{
+		return pegmatite::parse_proc();
+	}
+};
+}
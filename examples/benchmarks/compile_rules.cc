@@ -0,0 +1,110 @@
+/**
+ * Compares parsing with rules compiled into bytecode against walking the
+ * expression trees (`ParseOptions::compile_rules`), and against code
+ * generated from the grammar at build time by `generateParser()`.  Three
+ * grammars are measured (see grammars.hh): the calculator grammar from the
+ * examples, a JSON grammar, and a grammar for a small C-like language with
+ * keywords, which has larger choices for the compiler to dispatch on the
+ * next character.
+ */
+#include <cstdio>
+#include <string>
+#include "benchmark.hh"
+#include "grammars.hh"
+
+namespace
+{
+/**
+ * The ways of parsing that are compared.
+ */
+enum Mode
+{
+	TREES,
+	COMPILED,
+	GENERATED
+};
+
+/**
+ * Parses `text` by walking the trees, with compiled rules and with the code
+ * installed by `install`, and prints the results.  Each timed run parses the
+ * text `parses` times, so that short inputs take long enough to time
+ * reliably.
+ */
+template<typename Grammar>
+void measure(const char *name, const std::string &text, int parses,
+             bool (*install)(const Grammar &))
+{
+	benchmark::NoActions delegate;
+	StringViewInput input(text);
+	double times[3];
+	const char *names[] = { "trees", "compiled", "generated" };
+	for (int mode=TREES ; mode<=GENERATED ; mode++)
+	{
+		Grammar g;
+		if ((mode == GENERATED) && !install(g))
+		{
+			printf("%-12s %-10s (the generated code is out of date)\n",
+			       name, names[mode]);
+			return;
+		}
+		ParseOptions options;
+		options.compile_rules = (mode != TREES);
+		ParseStatistics statistics;
+		bool ok = true;
+		times[mode] = benchmark::bestTime(5, [&]()
+			{
+				for (int i=0 ; i<parses ; i++)
+				{
+					ErrorList errors;
+					ok &= parse(input, g.root, g.ws, errors, delegate, nullptr,
+					            options, statistics);
+				}
+			}) / parses;
+		printf("%-12s %-10s %12.2f %14llu %9.2fx%s\n", name, names[mode],
+		       times[mode],
+		       static_cast<unsigned long long>(statistics.rule_parses),
+		       times[TREES] / times[mode], ok ? "" : "  (parse failed)");
+	}
+	printf("\n");
+}
+}
+
+int main()
+{
+	printf("%-12s %-10s %12s %14s %10s\n", "grammar", "rules", "ms/parse",
+	       "rules parsed", "speedup");
+	std::string calculator = "1";
+	for (int i=2 ; i<=4000 ; i++)
+	{
+		calculator += "+-*/"[i % 4];
+		calculator += (i % 5 == 0) ? "(" + std::to_string(i) + ".5e2+1)"
+		                           : std::to_string(i);
+	}
+	measure<CalculatorGrammar>("calculator", calculator, 50,
+	                           installCalculatorParser);
+	std::string json = "[";
+	for (int i=0 ; i<20000 ; i++)
+	{
+		json += std::string(i ? "," : "") + "{\"id\": " + std::to_string(i) +
+		        ", \"name\": \"item\\\"" + std::to_string(i) +
+		        "\", \"tags\": [true, false, null, -1.5e3], "
+		        "\"nested\": {\"a\": [1, 2, {\"b\": \"c\"}]}}";
+	}
+	json += "]";
+	measure<JSONGrammar>("json", json, 1, installJSONParser);
+	std::string c;
+	for (int i=0 ; i<2000 ; i++)
+	{
+		std::string n = std::to_string(i);
+		c += "int f" + n + "(int a, int b)\n{\n"
+		     "\t// loop until done\n"
+		     "\tint x = a * 3 + b;\n"
+		     "\twhile (x > " + n + ") {\n"
+		     "\t\tif (x % 2 == 0) x = x / 2; else x = f" + n + "(x - 1, b);\n"
+		     "\t}\n"
+		     "\treturn x + returned;\n"
+		     "}\n";
+	}
+	measure<CGrammar>("c", c, 4, installCParser);
+	return 0;
+}
@@ -0,0 +1,44 @@
+/**
+ * Writes the C++ code for one of the grammars in grammars.hh to the file named
+ * by the first argument.  The grammar is chosen by `GRAMMAR`, which the build
+ * defines when compiling a generator for each grammar, and the install
+ * function is named after it.  This is run by the build, via
+ * pegmatite_generate_parser().
+ */
+#include <cstdio>
+#include "grammars.hh"
+
+#define STRINGIFY(x) #x
+#define NAME(x) STRINGIFY(x)
+#define GRAMMAR_CLASS(x) CLASS(x)
+#define CLASS(x) x##Grammar
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s output.cc\n", argv[0]);
+		return 1;
+	}
+	FILE *out = fopen(argv[1], "w");
+	if (!out)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	GRAMMAR_CLASS(GRAMMAR) g;
+	GeneratorOptions options;
+	options.header = "grammars.hh";
+	options.grammar = NAME(GRAMMAR_CLASS(GRAMMAR));
+	options.function = "install" NAME(GRAMMAR) "Parser";
+	bool ok = generateParser(out, options, g.rules());
+	if (fclose(out) != 0)
+	{
+		ok = false;
+	}
+	if (!ok)
+	{
+		perror(argv[1]);
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#ifndef PEGMATITE_BENCHMARK_GRAMMARS_HH
+#define PEGMATITE_BENCHMARK_GRAMMARS_HH
+
+#include <cstdio>
+#include <vector>
+#include "pegmatite.hh"
+
+// The grammars use the literal operators.
+using namespace pegmatite;
+
+/**
+ * The grammar from the calculator example.
+ */
+struct CalculatorGrammar
+{
+	Rule ws     = " \t\n"_E;
+	Rule digits = "[0-9]+"_R;
+	Rule num    = digits >> -('.'_E >> digits >> -("eE"_S >> -("+-"_S) >> digits));
+	Rule val    = num | '(' >> expr >> ')';
+	Rule mul_op = mul >> '*' >> mul;
+	Rule div_op = mul >> '/' >> mul;
+	Rule mul    = mul_op | div_op | val;
+	Rule add_op = expr >> '+' >> expr;
+	Rule sub_op = expr >> '-' >> expr;
+	Rule expr   = add_op | sub_op | mul;
+	Rule root   = expr;
+	//the rules, named by their members, for generateParser()
+	std::vector<GeneratorRule> rules() const
+	{
+		return { { "ws", ws }, { "digits", digits }, { "num", num },
+			{ "val", val }, { "mul_op", mul_op }, { "div_op", div_op },
+			{ "mul", mul }, { "add_op", add_op }, { "sub_op", sub_op },
+			{ "expr", expr }, { "root", root } };
+	}
+};
+
+/**
+ * A grammar for JSON.
+ */
+struct JSONGrammar
+{
+	Rule ws     = *" \t\n\r"_S;
+	Rule digit  = '0'_E - '9';
+	Rule number = term(-ExprPtr('-'_E) >> +digit >> -('.'_E >> +digit) >>
+	                   -("eE"_S >> -"+-"_S >> +digit));
+	Rule str    = term('"'_E >> *(('\\'_E >> any()) |
+	                              (!ExprPtr('"'_E) >> any())) >> '"');
+	Rule value  = str | number | object | array | "true"_E | "false"_E |
+	              "null"_E;
+	Rule member = str >> ':' >> value;
+	Rule object = '{'_E >> -(member >> *(','_E >> member)) >> '}';
+	Rule array  = '['_E >> -(value >> *(','_E >> value)) >> ']';
+	Rule root   = value;
+	//the rules, named by their members, for generateParser()
+	std::vector<GeneratorRule> rules() const
+	{
+		return { { "ws", ws }, { "digit", digit }, { "number", number },
+			{ "str", str }, { "value", value }, { "member", member },
+			{ "object", object }, { "array", array }, { "root", root } };
+	}
+};
+
+/**
+ * A grammar for functions in a small C-like language.
+ */
+struct CGrammar
+{
+	Rule ws         = *(" \t\n"_S | ("//"_E >> *(!ExprPtr('\n'_E) >> any())));
+	Rule letter     = ('a'_E - 'z') | ('A'_E - 'Z') | '_';
+	Rule ident_char = letter | ('0'_E - '9');
+	Rule keyword    = term(("if"_E | "else"_E | "while"_E | "return"_E |
+	                        "int"_E | "void"_E) >> !ExprPtr(ident_char));
+	Rule ident      = term(!ExprPtr(keyword) >> letter >> *ident_char);
+	Rule number     = term(+('0'_E - '9'));
+	Rule call       = ident >> '(' >> -(expr >> *(','_E >> expr)) >> ')';
+	Rule primary    = number | call | ident | '(' >> expr >> ')';
+	Rule unary      = ("-"_E | "!"_E) >> unary | primary;
+	Rule mul_op     = mul >> ("*"_E | "/"_E | "%"_E) >> unary;
+	Rule mul        = mul_op | unary;
+	Rule add_op     = add >> ("+"_E | "-"_E) >> mul;
+	Rule add        = add_op | mul;
+	Rule cmp_op     = add >> ("<="_E | ">="_E | "=="_E | "!="_E | "<"_E |
+	                          ">"_E) >> add;
+	Rule cmp        = cmp_op | add;
+	Rule assign     = ident >> '=' >> expr;
+	Rule expr       = assign | cmp;
+	Rule block      = '{'_E >> *stmt >> '}';
+	Rule if_stmt    = "if"_E >> '(' >> expr >> ')' >> stmt >>
+	                  -("else"_E >> stmt);
+	Rule while_stmt = "while"_E >> '(' >> expr >> ')' >> stmt;
+	Rule return_stmt = "return"_E >> -ExprPtr(expr) >> ';';
+	Rule decl       = "int"_E >> ident >> -('='_E >> expr) >> ';';
+	Rule stmt       = block | if_stmt | while_stmt | return_stmt | decl |
+	                  expr >> ';';
+	Rule type       = "int"_E | "void"_E;
+	Rule param      = "int"_E >> ident;
+	Rule function   = type >> ident >> '(' >> -(param >> *(','_E >> param)) >>
+	                  ')' >> block;
+	Rule root       = *function;
+	//the rules, named by their members, for generateParser()
+	std::vector<GeneratorRule> rules() const
+	{
+		return { { "ws", ws }, { "letter", letter },
+			{ "ident_char", ident_char }, { "keyword", keyword },
+			{ "ident", ident }, { "number", number }, { "call", call },
+			{ "primary", primary }, { "unary", unary }, { "mul_op", mul_op },
+			{ "mul", mul }, { "add_op", add_op }, { "add", add },
+			{ "cmp_op", cmp_op }, { "cmp", cmp }, { "assign", assign },
+			{ "expr", expr }, { "block", block }, { "if_stmt", if_stmt },
+			{ "while_stmt", while_stmt }, { "return_stmt", return_stmt },
+			{ "decl", decl }, { "stmt", stmt }, { "type", type },
+			{ "param", param }, { "function", function }, { "root", root } };
+	}
+};
+
+/**
+ * Install the code generated from each grammar (see generate_grammar.cc) on
+ * the rules of `g`.  Each returns false if the grammar has changed since the
+ * code was generated.
+ */
+bool installCalculatorParser(const CalculatorGrammar &g);
+bool installJSONParser(const JSONGrammar &g);
+bool installCParser(const CGrammar &g);
+
+#endif
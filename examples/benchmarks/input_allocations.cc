@@ -0,0 +1,152 @@
+/**
+ * Counts the heap allocations made on the input side of a parse, for each of
+ * the ways that a caller can hand an in-memory buffer to the parser.  The
+ * owning inputs copy or move the caller's data, while the borrowed inputs
+ * parse it in place and should allocate nothing.
+ *
+ * Parses go through a `ParseSession` that has already parsed the same input,
+ * so the parser's own tables are warm and the parser column shows what a
+ * steady-state parse costs.
+ */
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * A file of `name = number;` assignments.
+ */
+struct AssignmentGrammar
+{
+	Rule ws = " \t\n"_S;
+	Rule name = term(+('a'_E - 'z'));
+	Rule number = term(+('0'_E - '9'));
+	Rule assignment = name >> '=' >> number >> ';';
+	Rule file = *assignment;
+};
+
+//the number of parses to average over
+const int runs = 20;
+
+/**
+ * Counts the allocations made while constructing an input and while parsing
+ * it.
+ */
+struct Measurement
+{
+	//the session used for parsing
+	ParseSession &session;
+	//the grammar
+	const AssignmentGrammar &g;
+	//allocation counts when the current input started to be constructed
+	uint64_t allocations = 0, bytes = 0;
+	//totals for the input side and the parser side
+	uint64_t input_allocations = 0, input_bytes = 0, parse_allocations = 0;
+	//set if any parse fails
+	bool failed = false;
+
+	Measurement(ParseSession &s, const AssignmentGrammar &grammar) :
+		session(s), g(grammar) {}
+	/**
+	 * Called before the input is constructed.
+	 */
+	void start()
+	{
+		allocations = benchmark::allocationCount();
+		bytes = benchmark::allocatedBytes();
+	}
+	/**
+	 * Parses the input, adding to the totals.
+	 */
+	void parse(Input &input)
+	{
+		uint64_t made = benchmark::allocationCount();
+		input_allocations += made - allocations;
+		input_bytes += benchmark::allocatedBytes() - bytes;
+		benchmark::NoActions delegate;
+		ErrorList errors;
+		failed |= !session.parse(input, g.file, g.ws, errors, delegate,
+		                         nullptr);
+		parse_allocations += benchmark::allocationCount() - made;
+	}
+};
+
+/**
+ * Calls `f` `runs` times, each time constructing and parsing one input, and
+ * prints the average allocations per parse.
+ */
+template<typename F>
+void measure(const char *name, ParseSession &session,
+             const AssignmentGrammar &g, F f)
+{
+	// The first parse warms up the session.
+	Measurement warm_up(session, g);
+	f(warm_up);
+	Measurement m(session, g);
+	for (int i=0 ; i<runs ; i++)
+	{
+		f(m);
+	}
+	printf("%-28s %10.1f %12.0f %10.1f%s\n", name,
+	       double(m.input_allocations) / runs, double(m.input_bytes) / runs,
+	       double(m.parse_allocations) / runs,
+	       m.failed ? "  (parse failed)" : "");
+}
+}
+
+int main()
+{
+	AssignmentGrammar g;
+	std::string text;
+	for (int i=0 ; i<20000 ; i++)
+	{
+		text += "value = " + std::to_string(i) + ";\n";
+	}
+	std::vector<char32_t> characters(text.begin(), text.end());
+	ParseSession session;
+
+	printf("%zu bytes of input, average per parse over %d parses\n\n",
+	       text.size(), runs);
+	printf("%-28s %10s %12s %10s\n", "input", "input new", "input bytes",
+	       "parse new");
+	// The caller's buffer already exists, so copies of it that a caller makes
+	// to hand over ownership are made before counting starts.
+	std::vector<std::string> strings(runs + 1, text);
+	std::vector<std::vector<char32_t>> vectors(runs + 1, characters);
+	int next_string = 0, next_vector = 0;
+	measure("StringInput (copy)", session, g, [&](Measurement &m)
+		{
+			m.start();
+			StringInput input(text);
+			m.parse(input);
+		});
+	measure("StringInput (move)", session, g, [&](Measurement &m)
+		{
+			m.start();
+			StringInput input(std::move(strings[next_string++]));
+			m.parse(input);
+		});
+	measure("UnicodeVectorInput (move)", session, g, [&](Measurement &m)
+		{
+			m.start();
+			UnicodeVectorInput input(std::move(vectors[next_vector++]));
+			m.parse(input);
+		});
+	measure("StringViewInput", session, g, [&](Measurement &m)
+		{
+			m.start();
+			StringViewInput input(text);
+			m.parse(input);
+		});
+	measure("UnicodeSpanInput", session, g, [&](Measurement &m)
+		{
+			m.start();
+			UnicodeSpanInput input(characters.data(), characters.size());
+			m.parse(input);
+		});
+	return 0;
+}
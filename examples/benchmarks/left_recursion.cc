@@ -0,0 +1,99 @@
+/**
+ * Measures how parse time grows with the length of a chain of additions, such
+ * as `1+2+3+...`.  Seed growing parses each left-recursive rule a bounded
+ * number of times at each position, so the number of rules parsed per term
+ * should stay constant as the chain gets longer.
+ *
+ * Two grammars are measured.  The first is the grammar from the calculator
+ * example, where both operands of `+` are expressions.  The right operand
+ * then recurses into the rest of the chain, so the depth of recursion grows
+ * with the length of the chain and long chains exhaust the stack.  The second
+ * is the usual left-associative form, where the right operand is a term, and
+ * recursion depth is constant.
+ */
+#include <cstdio>
+#include <string>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * The grammar from the calculator example.
+ */
+struct CalculatorGrammar
+{
+	Rule ws     = " \t\n"_E;
+	Rule digits = "[0-9]+"_R;
+	Rule num    = digits >> -('.'_E >> digits >> -("eE"_S >> -("+-"_S) >> digits));
+	Rule val    = num | '(' >> expr >> ')';
+	Rule mul_op = mul >> '*' >> mul;
+	Rule div_op = mul >> '/' >> mul;
+	Rule mul    = mul_op | div_op | val;
+	Rule add_op = expr >> '+' >> expr;
+	Rule sub_op = expr >> '-' >> expr;
+	Rule expr   = add_op | sub_op | mul;
+};
+
+/**
+ * The calculator grammar with left-associative operators.
+ */
+struct LeftAssociativeGrammar
+{
+	Rule ws     = " \t\n"_E;
+	Rule digits = "[0-9]+"_R;
+	Rule num    = digits >> -('.'_E >> digits >> -("eE"_S >> -("+-"_S) >> digits));
+	Rule val    = num | '(' >> expr >> ')';
+	Rule mul_op = mul >> '*' >> val;
+	Rule div_op = mul >> '/' >> val;
+	Rule mul    = mul_op | div_op | val;
+	Rule add_op = expr >> '+' >> mul;
+	Rule sub_op = expr >> '-' >> mul;
+	Rule expr   = add_op | sub_op | mul;
+};
+
+/**
+ * Parses chains of between `min_terms` and `max_terms` terms, doubling the
+ * length each time, and prints the results.
+ */
+template<typename Grammar>
+void measure(const char *name, int min_terms, int max_terms)
+{
+	Grammar g;
+	benchmark::NoActions delegate;
+	printf("%s\n", name);
+	printf("%8s %12s %12s %16s\n", "terms", "time (ms)", "ns per term",
+	       "rules per term");
+	for (int terms=min_terms ; terms<=max_terms ; terms*=2)
+	{
+		std::string text = "1";
+		for (int i=2 ; i<=terms ; i++)
+		{
+			text += "+" + std::to_string(i);
+		}
+		StringViewInput input(text);
+		ParseStatistics statistics;
+		bool ok = true;
+		double time = benchmark::bestTime(3, [&]()
+			{
+				ErrorList errors;
+				ok &= parse(input, g.expr, g.ws, errors, delegate, nullptr,
+				            ParseOptions(), statistics);
+			});
+		printf("%8d %12.2f %12.0f %16.1f%s\n", terms, time,
+		       time * 1e6 / terms, double(statistics.rule_parses) / terms,
+		       ok ? "" : "  (parse failed)");
+	}
+	printf("\n");
+}
+}
+
+int main()
+{
+	measure<CalculatorGrammar>("calculator grammar (expr '+' expr)", 250,
+	                           4000);
+	measure<LeftAssociativeGrammar>("left-associative grammar (expr '+' mul)",
+	                                250, 256000);
+	return 0;
+}
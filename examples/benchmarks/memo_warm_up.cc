@@ -0,0 +1,109 @@
+/**
+ * Compares parsing with every rule memoized against parsing after a warm-up
+ * parse has chosen which rules to memoize.  The grammar is a list of words,
+ * numbers and keywords, where no rule is ever parsed twice at the same
+ * position, so memoization costs a lookup and an insertion for every rule
+ * and saves nothing.
+ */
+#include <cstdio>
+#include <memory>
+#include <string>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * A list of words, numbers and keywords.
+ */
+struct WordGrammar
+{
+	Rule ws = " \t\n"_S;
+	Rule word = term(+('a'_E - 'z'));
+	Rule number = term(+('0'_E - '9'));
+	Rule keyword = "hello"_E;
+	Rule item = keyword | word | number;
+	Rule items = *item;
+};
+
+/**
+ * Returns the name of a memoization policy.
+ */
+const char *policyName(MemoPolicy p)
+{
+	switch (p)
+	{
+	case MEMO_ALWAYS:
+		return "always";
+	case MEMO_NEVER:
+		return "never";
+	case MEMO_AUTO:
+		return "auto";
+	}
+	return "?";
+}
+}
+
+int main()
+{
+	WordGrammar g;
+	const char *words[] = { "hello", "parser", "memo", "42", "table", "1024" };
+	std::string text;
+	for (int i=0 ; i<120000 ; i++)
+	{
+		text += words[i % 6];
+		text += (i % 10 == 9) ? '\n' : ' ';
+	}
+	StringViewInput input(text);
+	benchmark::NoActions delegate;
+	struct
+	{
+		const char *name;
+		Rule *rule;
+	} rules[] = {
+		{ "ws", std::addressof(g.ws) },
+		{ "word", std::addressof(g.word) },
+		{ "number", std::addressof(g.number) },
+		{ "keyword", std::addressof(g.keyword) },
+		{ "item", std::addressof(g.item) },
+		{ "items", std::addressof(g.items) }
+	};
+	auto measure = [&](const char *name)
+	{
+		ParseStatistics statistics;
+		bool ok = true;
+		double time = benchmark::bestTime(5, [&]()
+			{
+				ErrorList errors;
+				ok &= parse(input, g.items, g.ws, errors, delegate, nullptr,
+				            ParseOptions(), statistics);
+			});
+		printf("%-24s %10.1f %16llu%s\n", name, time,
+		       (unsigned long long)statistics.memo_insertions,
+		       ok ? "" : "  (parse failed)");
+	};
+
+	printf("%zu bytes of input\n\n", text.size());
+	printf("%-24s %10s %16s\n", "policy", "time (ms)", "memo insertions");
+	measure("MEMO_ALWAYS (default)");
+
+	for (auto &r : rules)
+	{
+		r.rule->setMemoPolicy(MEMO_AUTO);
+	}
+	ParseOptions warm_up;
+	warm_up.memo_warm_up = true;
+	ParseStatistics statistics;
+	ErrorList errors;
+	parse(input, g.items, g.ws, errors, delegate, nullptr, warm_up,
+	      statistics);
+	measure("MEMO_AUTO after warm-up");
+
+	printf("\nchosen policies:\n");
+	for (auto &r : rules)
+	{
+		printf("  %-10s %s\n", r.name, policyName(r.rule->chosenMemoPolicy()));
+	}
+	return 0;
+}
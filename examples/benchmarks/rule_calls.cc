@@ -0,0 +1,88 @@
+/**
+ * Measures the cost of a rule invocation, and whether it depends on how many
+ * rules the program has constructed.  The parser keeps per-rule state for
+ * each grammar, so a grammar should parse at the same speed however many
+ * other rules exist.
+ *
+ * The grammar parses a short list of words through a chain of rules, and is
+ * parsed many times, so that the cost of starting a parse is included.  The
+ * measurement is repeated after constructing rules that belong to no grammar,
+ * and with a grammar constructed after them.
+ */
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "benchmark.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * A list of words, each parsed through a chain of eight rules.
+ */
+struct ChainGrammar
+{
+	Rule ws    = " \t\n"_E;
+	Rule word  = term(+range('a', 'z'));
+	Rule r7    = word;
+	Rule r6    = r7;
+	Rule r5    = r6;
+	Rule r4    = r5;
+	Rule r3    = r4;
+	Rule r2    = r3;
+	Rule r1    = r2;
+	Rule r0    = r1;
+	Rule words = *r0;
+};
+
+/**
+ * The number of parses timed in each run.
+ */
+const int parses = 2000;
+
+/**
+ * Parses `text` with `g` and prints the time per rule invocation.
+ */
+void measure(const char *name, const ChainGrammar &g, const std::string &text)
+{
+	benchmark::NoActions delegate;
+	StringViewInput input(text);
+	ParseStatistics statistics;
+	bool ok = true;
+	double time = benchmark::bestTime(5, [&]()
+		{
+			for (int i=0 ; i<parses ; i++)
+			{
+				ErrorList errors;
+				ok &= parse(input, g.words, g.ws, errors, delegate, nullptr,
+				            ParseOptions(), statistics);
+			}
+		});
+	printf("%-40s %12.2f %12.1f%s\n", name, time,
+	       time * 1e6 / (double(statistics.rule_parses) * parses),
+	       ok ? "" : "  (parse failed)");
+}
+}
+
+int main()
+{
+	std::string text;
+	for (int i=0 ; i<16 ; i++)
+	{
+		text += "lorem ipsum dolor sit amet ";
+	}
+	printf("%-40s %12s %12s\n", "", "time (ms)", "ns per rule");
+	ChainGrammar first;
+	measure("grammar constructed first", first, text);
+	std::vector<std::unique_ptr<Rule>> other_rules;
+	for (int i=0 ; i<1000000 ; i++)
+	{
+		other_rules.emplace_back(new Rule('x'_E));
+	}
+	measure("after 1000000 other rules", first, text);
+	ChainGrammar last;
+	measure("grammar constructed after them", last, text);
+	return 0;
+}
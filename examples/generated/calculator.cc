@@ -0,0 +1,129 @@
+/**
+ * Evaluates expressions with the calculator grammar, once with the rules
+ * parsed by the library and once with the code generated from them
+ * installed, and checks that both give the same results and errors.  The
+ * exit status is non-zero if they differ or the generated code can't be
+ * installed.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "calculator.hh"
+
+namespace
+{
+/**
+ * A delegate that evaluates the expression as the matches are processed.
+ * Matches are processed after the ones that they contain, so each operator
+ * finds its operands on the top of the stack.
+ */
+class Evaluator : public ParserDelegate
+{
+	const CalculatorGrammar &g;
+public:
+	mutable std::vector<double> stack;
+	Evaluator(const CalculatorGrammar &grammar) : g(grammar) {}
+	parse_proc get_parse_proc(const Rule &r) const override
+	{
+		const Rule *rule = std::addressof(r);
+		if (rule == std::addressof(g.num))
+		{
+			return [this](const ParserPosition &b, const ParserPosition &e,
+			              void*)
+				{
+					stack.push_back(strtod(InputRange(b, e).str().c_str(),
+					                       nullptr));
+				};
+		}
+		char op = (rule == std::addressof(g.add_op)) ? '+' :
+		          (rule == std::addressof(g.sub_op)) ? '-' :
+		          (rule == std::addressof(g.mul_op)) ? '*' :
+		          (rule == std::addressof(g.div_op)) ? '/' : 0;
+		if (!op)
+		{
+			return parse_proc();
+		}
+		return [this, op](const ParserPosition &, const ParserPosition &,
+		                  void*)
+			{
+				double right = stack.back();
+				stack.pop_back();
+				double &left = stack.back();
+				switch (op)
+				{
+				case '+':
+					left += right;
+					break;
+				case '-':
+					left -= right;
+					break;
+				case '*':
+					left *= right;
+					break;
+				case '/':
+					left = (right != 0) ? left / right : 0;
+					break;
+				}
+			};
+	}
+};
+
+/**
+ * Parses `text` with `g`, returning a description of the result.
+ */
+std::string evaluate(const CalculatorGrammar &g, const std::string &text)
+{
+	StringInput input(text);
+	Evaluator evaluator(g);
+	ErrorList errors;
+	char result[64];
+	if (parse(input, g.expr, g.ws, errors, evaluator, nullptr))
+	{
+		snprintf(result, sizeof(result), "result = %g",
+		         evaluator.stack.empty() ? 0 : evaluator.stack.back());
+	}
+	else
+	{
+		const Error &e = errors.front();
+		snprintf(result, sizeof(result), "error %d at line %d, col %d",
+		         e.error_type, e.start.line, e.start.col);
+	}
+	return result;
+}
+}
+
+int main()
+{
+	CalculatorGrammar interpreted;
+	CalculatorGrammar generated;
+	if (!installCalculatorParser(generated))
+	{
+		fprintf(stderr, "The generated code doesn't match the grammar\n");
+		return 1;
+	}
+	std::vector<std::string> expressions = { "1+2*3", "(1+2)*3", "1-2-3",
+		"2*3+4*5-6/2", "1.5e2+2", "((4))", "3.14 / 7.1", "1+", "(1",
+		"1+)", "2*x" };
+	std::string chain = "1";
+	for (int i=2 ; i<=1000 ; i++)
+	{
+		chain += "+-*/"[i % 4] + std::to_string(i);
+	}
+	expressions.push_back(chain);
+	int failures = 0;
+	for (const std::string &text : expressions)
+	{
+		std::string expected = evaluate(interpreted, text);
+		std::string result = evaluate(generated, text);
+		bool same = (result == expected);
+		printf("%-20.20s %s%s\n", text.c_str(), result.c_str(),
+		       same ? "" : (" (interpreter: " + expected + ")").c_str());
+		if (!same)
+		{
+			failures++;
+		}
+	}
+	return failures ? 1 : 0;
+}
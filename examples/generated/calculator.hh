@@ -0,0 +1,35 @@
+#ifndef PEGMATITE_EXAMPLE_GENERATED_CALCULATOR_HH
+#define PEGMATITE_EXAMPLE_GENERATED_CALCULATOR_HH
+
+#include "pegmatite.hh"
+
+// The grammar uses the literal operators, as in the calculator example.
+using namespace pegmatite;
+
+/**
+ * The grammar from the calculator example.  Rules are named by the members
+ * that hold them when generating code, so they must be accessible to the
+ * generated install function.
+ */
+struct CalculatorGrammar
+{
+	Rule ws     = " \t\n"_E;
+	Rule digits = "[0-9]+"_R;
+	Rule num    = digits >> -('.'_E >> digits >> -("eE"_S >> -("+-"_S) >> digits));
+	Rule val    = num | '(' >> expr >> ')';
+	Rule mul_op = mul >> '*' >> mul;
+	Rule div_op = mul >> '/' >> mul;
+	Rule mul    = mul_op | div_op | val;
+	Rule add_op = expr >> '+' >> expr;
+	Rule sub_op = expr >> '-' >> expr;
+	Rule expr   = add_op | sub_op | mul;
+};
+
+/**
+ * Installs the code generated from the grammar on the rules of `g`.  This is
+ * defined in the file written by the generate_calculator program.  Returns
+ * false if the grammar has changed since the code was generated.
+ */
+bool installCalculatorParser(const CalculatorGrammar &g);
+
+#endif
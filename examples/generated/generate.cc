@@ -0,0 +1,40 @@
+/**
+ * Writes the C++ code for the calculator grammar to the file named by the
+ * first argument.  This is run by the build, via pegmatite_generate_parser().
+ */
+#include <cstdio>
+#include "calculator.hh"
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s output.cc\n", argv[0]);
+		return 1;
+	}
+	FILE *out = fopen(argv[1], "w");
+	if (!out)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	CalculatorGrammar g;
+	GeneratorOptions options;
+	options.header = "calculator.hh";
+	options.grammar = "CalculatorGrammar";
+	options.function = "installCalculatorParser";
+	bool ok = generateParser(out, options, {
+		{ "ws", g.ws }, { "digits", g.digits }, { "num", g.num },
+		{ "val", g.val }, { "mul_op", g.mul_op }, { "div_op", g.div_op },
+		{ "mul", g.mul }, { "add_op", g.add_op }, { "sub_op", g.sub_op },
+		{ "expr", g.expr } });
+	if (fclose(out) != 0)
+	{
+		ok = false;
+	}
+	if (!ok)
+	{
+		perror(argv[1]);
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,702 @@
+/*-
+ * Copyright (c) 2012, Achilleas Margaritis
+ * Copyright (c) 2014, David T. Chisnall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEGMATITE_EXPRESSION_TEMPLATES_HPP
+#define PEGMATITE_EXPRESSION_TEMPLATES_HPP
+
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include "parser.hh"
+
+
+/**
+ * An alternative front end for writing grammars, in which the operators build
+ * expression templates rather than trees of `Expr` objects.  An expression
+ * such as `lit("0x") >> +range('0', '9')` has the type
+ * `Seq<Lit, Plus<Range>>`, so the compiler can see the whole expression and
+ * inline it into a single function.
+ *
+ * Expressions are turned into an `ExprPtr` with `expr()`, which can then be
+ * used to initialise a `Rule`.  Named rules are memoized and reported to the
+ * `ParserDelegate` as usual, so they can be bound with `BindAST`.  Rules can
+ * be referred to from expression templates, and other expressions can be
+ * included with `dyn()`.  For example:
+ *
+ *     namespace t = pegmatite::templates;
+ *     Rule digits = t::expr(t::term(+t::range('0', '9')));
+ *     Rule list = t::expr('[' >> -(t::ref(digits) >> *(',' >> t::ref(digits)))
+ *                         >> ']');
+ *
+ * The factory functions share names with those in the `pegmatite` namespace,
+ * so they should be qualified when both namespaces are in use.
+ */
+namespace pegmatite {
+namespace templates {
+
+/**
+ * Base class for expression templates.  `Derived` is the expression type.
+ * This exists only so that the operators apply to expression templates and
+ * nothing else.
+ */
+template<typename Derived>
+struct Pattern
+{
+	/**
+	 * Returns this expression as its real type.
+	 */
+	const Derived &derived() const
+	{
+		return static_cast<const Derived&>(*this);
+	}
+	//add the rules referred to; leaves refer to none
+	void rules(std::vector<const Rule*> &) const {}
+};
+
+/**
+ * Matches a single character.
+ */
+struct Char : public Pattern<Char>
+{
+	//constructor
+	Char(char32_t ch) : c(ch) {}
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		return con.character(c);
+	}
+	//the character
+	char32_t c;
+};
+
+/**
+ * Matches a string.  The characters are not copied, so must outlive the
+ * expression, as string literals do.
+ */
+struct Lit : public Pattern<Lit>
+{
+	//constructor
+	Lit(const char *str, size_t len) : s(str), length(len) {}
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		for (size_t i = 0; i < length; i++)
+		{
+			if (!con.character(static_cast<unsigned char>(s[i])))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	//the characters
+	const char *s;
+	//the number of characters
+	size_t length;
+};
+
+/**
+ * Matches a character in a range.
+ */
+struct Range : public Pattern<Range>
+{
+	//constructor
+	Range(char32_t min, char32_t max) : first(min), last(max) {}
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		char32_t c;
+		if (con.peek(c) && (c >= first) && (c <= last))
+		{
+			con.advance();
+			return true;
+		}
+		con.mismatch();
+		return false;
+	}
+	//the first character of the range
+	char32_t first;
+	//the last character of the range
+	char32_t last;
+};
+
+/**
+ * Matches any of the characters in a string.  The characters are not copied,
+ * so must outlive the expression, as string literals do.
+ */
+struct Set : public Pattern<Set>
+{
+	//constructor
+	Set(const char *str) : s(str) {}
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		char32_t c;
+		if (con.peek(c) && (c != 0) && (c < 128) &&
+		    strchr(s, static_cast<char>(c)))
+		{
+			con.advance();
+			return true;
+		}
+		con.mismatch();
+		return false;
+	}
+	//the characters
+	const char *s;
+};
+
+/**
+ * Matches any character.
+ */
+struct Any : public Pattern<Any>
+{
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		return con.any();
+	}
+};
+
+/**
+ * Parses a rule.
+ */
+struct RuleRef : public Pattern<RuleRef>
+{
+	//constructor
+	RuleRef(const Rule &r) : rule(std::addressof(r)) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		return con.rule(*rule, term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		out.push_back(rule);
+	}
+	//the rule
+	const Rule *rule;
+};
+
+/**
+ * Parses an expression that was built without templates.
+ */
+struct Dyn : public Pattern<Dyn>
+{
+	//constructor
+	Dyn(const ExprPtr &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		return con.expression(*expr.get(), term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr->rules(out);
+	}
+	//the expression
+	ExprPtr expr;
+};
+
+/**
+ * Matches `A` and then `B`, with whitespace in between for non-terminals.
+ */
+template<typename A, typename B>
+struct Seq : public Pattern<Seq<A, B>>
+{
+	//constructor
+	Seq(const A &l, const B &r) : left(l), right(r) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		if (!left.match(con, term))
+		{
+			return false;
+		}
+		if (!term)
+		{
+			con.whitespace();
+		}
+		return right.match(con, term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		left.rules(out);
+		right.rules(out);
+	}
+	//the first expression
+	A left;
+	//the second expression
+	B right;
+};
+
+/**
+ * Matches `A`, or `B` if `A` doesn't match.
+ */
+template<typename A, typename B>
+struct Choice : public Pattern<Choice<A, B>>
+{
+	//constructor
+	Choice(const A &l, const B &r) : left(l), right(r) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		GeneratedContext::Mark m = con.mark();
+		if (left.match(con, term))
+		{
+			con.release(m);
+			return true;
+		}
+		return con.reset(m) && right.match(con, term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		left.rules(out);
+		right.rules(out);
+	}
+	//the first alternative
+	A left;
+	//the second alternative
+	B right;
+};
+
+/**
+ * Matches `e` as many times as possible.  Non-terminals parse whitespace
+ * before each match.  This fails only if a cut prevents backtracking after
+ * the last attempt.
+ */
+template<typename A>
+bool matchRepeated(const A &e, GeneratedContext &con, bool term)
+{
+	for (;;)
+	{
+		if (!term)
+		{
+			con.whitespace();
+		}
+		GeneratedContext::Mark m = con.mark();
+		if (!e.match(con, term))
+		{
+			return con.reset(m);
+		}
+		con.release(m);
+	}
+}
+
+/**
+ * Matches zero or more instances of `A`.
+ */
+template<typename A>
+struct Star : public Pattern<Star<A>>
+{
+	//constructor
+	Star(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		return matchRepeated(expr, con, term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the repeated expression
+	A expr;
+};
+
+/**
+ * Matches one or more instances of `A`.
+ */
+template<typename A>
+struct Plus : public Pattern<Plus<A>>
+{
+	//constructor
+	Plus(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		if (!term)
+		{
+			con.whitespace();
+		}
+		return expr.match(con, term) && matchRepeated(expr, con, term);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the repeated expression
+	A expr;
+};
+
+/**
+ * Matches zero or one instance of `A`.
+ */
+template<typename A>
+struct Opt : public Pattern<Opt<A>>
+{
+	//constructor
+	Opt(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		GeneratedContext::Mark m = con.mark();
+		if (expr.match(con, term))
+		{
+			con.release(m);
+			return true;
+		}
+		return con.reset(m);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the optional expression
+	A expr;
+};
+
+/**
+ * Matches if `A` matches, without consuming any input.
+ */
+template<typename A>
+struct And : public Pattern<And<A>>
+{
+	//constructor
+	And(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		GeneratedContext::Mark m = con.mark();
+		bool ok = expr.match(con, term);
+		return con.reset(m) && ok;
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the expression to test
+	A expr;
+};
+
+/**
+ * Matches if `A` doesn't match, without consuming any input.
+ */
+template<typename A>
+struct Not : public Pattern<Not<A>>
+{
+	//constructor
+	Not(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		GeneratedContext::Mark m = con.mark();
+		bool ok = !expr.match(con, term);
+		return con.reset(m) && ok;
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the expression to test
+	A expr;
+};
+
+/**
+ * Matches `A` as a terminal, without whitespace.
+ */
+template<typename A>
+struct Term : public Pattern<Term<A>>
+{
+	//constructor
+	Term(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool) const
+	{
+		return expr.match(con, true);
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the expression
+	A expr;
+};
+
+/**
+ * Matches `A` and advances the line counter.
+ */
+template<typename A>
+struct Newline : public Pattern<Newline<A>>
+{
+	//constructor
+	Newline(const A &e) : expr(e) {}
+	//parse
+	bool match(GeneratedContext &con, bool term) const
+	{
+		if (!expr.match(con, term))
+		{
+			return false;
+		}
+		con.newline();
+		return true;
+	}
+	//add the rules referred to
+	void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	//the expression
+	A expr;
+};
+
+/**
+ * Adaptor that lets an expression template be used wherever an `Expr` is
+ * expected.
+ */
+template<typename A>
+class PatternExpr : public GeneratedExpr
+{
+public:
+	//constructor
+	PatternExpr(const A &e) : expr(e) {}
+	virtual bool match(GeneratedContext &con, bool term) const
+	{
+		return expr.match(con, term);
+	}
+	virtual void rules(std::vector<const Rule*> &out) const
+	{
+		expr.rules(out);
+	}
+	virtual void dump() const
+	{
+		fprintf(stderr, "<expression template>");
+	}
+private:
+	//the expression
+	A expr;
+};
+
+/**
+ * Returns an expression that parses with the expression template `e`, for
+ * use as the expression of a `Rule`.
+ */
+template<typename A>
+ExprPtr expr(const Pattern<A> &e)
+{
+	return ExprPtr(new PatternExpr<A>(e.derived()));
+}
+
+/**
+ * Returns an expression that matches the character `c`.
+ */
+inline Char chr(char32_t c)
+{
+	return Char(c);
+}
+
+/**
+ * Returns an expression that matches the string `s`, which must outlive it.
+ */
+inline Lit lit(const char *s)
+{
+	return Lit(s, strlen(s));
+}
+
+/**
+ * Returns an expression that matches any character between `min` and `max`
+ * inclusive.
+ */
+inline Range range(char32_t min, char32_t max)
+{
+	return Range(min, max);
+}
+
+/**
+ * Returns an expression that matches any of the ASCII characters in `s`,
+ * which must outlive it.
+ */
+inline Set set(const char *s)
+{
+	return Set(s);
+}
+
+/**
+ * Returns an expression that matches any character.
+ */
+inline Any any()
+{
+	return Any();
+}
+
+/**
+ * Returns an expression that parses the rule `r`.
+ */
+inline RuleRef ref(const Rule &r)
+{
+	return RuleRef(r);
+}
+
+/**
+ * Returns an expression that parses `e`, which was built without templates.
+ */
+inline Dyn dyn(const ExprPtr &e)
+{
+	return Dyn(e);
+}
+
+/**
+ * Returns an expression that matches `e` as a terminal.
+ */
+template<typename A>
+Term<A> term(const Pattern<A> &e)
+{
+	return Term<A>(e.derived());
+}
+
+/**
+ * Returns an expression that matches `e` and advances the line counter.
+ */
+template<typename A>
+Newline<A> nl(const Pattern<A> &e)
+{
+	return Newline<A>(e.derived());
+}
+
+/**
+ * Zero or more instances of `e`.
+ */
+template<typename A>
+Star<A> operator*(const Pattern<A> &e)
+{
+	return Star<A>(e.derived());
+}
+
+/**
+ * One or more instances of `e`.
+ */
+template<typename A>
+Plus<A> operator+(const Pattern<A> &e)
+{
+	return Plus<A>(e.derived());
+}
+
+/**
+ * Zero or one instance of `e`.
+ */
+template<typename A>
+Opt<A> operator-(const Pattern<A> &e)
+{
+	return Opt<A>(e.derived());
+}
+
+/**
+ * And-predicate: matches if `e` matches, without consuming input.
+ */
+template<typename A>
+And<A> operator&(const Pattern<A> &e)
+{
+	return And<A>(e.derived());
+}
+
+/**
+ * Not-predicate: matches if `e` doesn't match, without consuming input.
+ */
+template<typename A>
+Not<A> operator!(const Pattern<A> &e)
+{
+	return Not<A>(e.derived());
+}
+
+/**
+ * Defines the binary operator `op`, which builds a `Type`, for expression
+ * templates and for mixing them with rules, characters and strings.
+ */
+#define PEGMATITE_TEMPLATE_BINARY_OPERATOR(op, Type)                          \
+template<typename A, typename B>                                              \
+Type<A, B> operator op(const Pattern<A> &l, const Pattern<B> &r)              \
+{                                                                             \
+	return Type<A, B>(l.derived(), r.derived());                              \
+}                                                                             \
+template<typename A>                                                          \
+Type<A, RuleRef> operator op(const Pattern<A> &l, const Rule &r)              \
+{                                                                             \
+	return Type<A, RuleRef>(l.derived(), RuleRef(r));                         \
+}                                                                             \
+template<typename B>                                                          \
+Type<RuleRef, B> operator op(const Rule &l, const Pattern<B> &r)              \
+{                                                                             \
+	return Type<RuleRef, B>(RuleRef(l), r.derived());                         \
+}                                                                             \
+template<typename A>                                                          \
+Type<A, Char> operator op(const Pattern<A> &l, char r)                        \
+{                                                                             \
+	return Type<A, Char>(l.derived(), Char(static_cast<unsigned char>(r)));   \
+}                                                                             \
+template<typename B>                                                          \
+Type<Char, B> operator op(char l, const Pattern<B> &r)                        \
+{                                                                             \
+	return Type<Char, B>(Char(static_cast<unsigned char>(l)), r.derived());   \
+}                                                                             \
+template<typename A>                                                          \
+Type<A, Lit> operator op(const Pattern<A> &l, const char *r)                  \
+{                                                                             \
+	return Type<A, Lit>(l.derived(), lit(r));                                 \
+}                                                                             \
+template<typename B>                                                          \
+Type<Lit, B> operator op(const char *l, const Pattern<B> &r)                  \
+{                                                                             \
+	return Type<Lit, B>(lit(l), r.derived());                                 \
+}
+
+/**
+ * Sequence: matches the left expression and then the right.
+ */
+PEGMATITE_TEMPLATE_BINARY_OPERATOR(>>, Seq)
+
+/**
+ * Choice: matches the left expression, or the right if it doesn't match.
+ */
+PEGMATITE_TEMPLATE_BINARY_OPERATOR(|, Choice)
+
+#undef PEGMATITE_TEMPLATE_BINARY_OPERATOR
+
+} //namespace templates
+} //namespace pegmatite
+
+
+#endif //PEGMATITE_EXPRESSION_TEMPLATES_HPP
@@ -25,18 +25,32 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cinttypes>
+#include <cstdint>
 #include <cstdlib>
+#include <condition_variable>
 #include <cstring>
 #include <cassert>
+#include <cerrno>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
+#include <mutex>
 #include <regex>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "parser.hh"
 
@@ -44,6 +58,13 @@
 using namespace pegmatite;
 
 namespace {
+/**
+ * A vector that allocates from an arena, or from the heap if its allocator
+ * has no arena.
+ */
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
 //parser state
 // FIXME: This class has an uninformative name.
 class ParsingState
@@ -52,11 +73,23 @@ public:
 	//position
 	ParserPosition position;
 
-	//size of match vector
-	size_t matches;
+	//point in the match log (a MatchLog::Ref)
+	uint32_t matches;
 
 	//constructor
 	ParsingState(Context &con);
+
+	//destructor
+	~ParsingState();
+
+	//parsing states are backtrack points and so must not be copied
+	ParsingState(const ParsingState &) = delete;
+
+	//the number of cuts that had been parsed when this state was saved
+	uint64_t cuts;
+private:
+	//the context, if it is tracking backtrack points, or null otherwise
+	Context *pinned;
 };
 
 
@@ -87,1679 +120,5815 @@ public:
 };
 
 /**
- * String expression.  Matches a sequence of characters.
+ * The log of matched rules.  This is a persistent, append-only structure: a
+ * reference to a point in the log identifies the complete sequence of matches
+ * up to that point, and remains valid when more matches are added after it.
+ * Backtracking is therefore just a matter of returning to an earlier
+ * reference, and the memo table can refer to a run of matches without
+ * copying it.
+ *
+ * Each node either records a single match or splices in a run of matches
+ * that is already in the log, so adding a cached run of any length is
+ * constant time.  Nodes are never freed during a parse, so the log also
+ * holds the matches from abandoned branches until it is cleared.
  */
-class StringExpr : public Expr
+class MatchLog
 {
 public:
 	/**
-	 * Returns a new string expression recognising the specified string.
-	 */
-	StringExpr(const char *s) : characters(s, s + strlen(s)) {}
-	/**
-	 * Returns a new string expression recognising the specified string.
+	 * A reference to a point in the log.  This is the index of the last node
+	 * plus one, so that zero can refer to the empty log.
 	 */
-	StringExpr(const char *s, std::size_t length) : characters(s, s + length) {}
-	virtual bool parse_non_term(Context &con) const;
-	virtual bool parse_term(Context &con) const;
-	virtual void dump() const;
-private:
+	typedef uint32_t Ref;
 	/**
-	 * The characters that this expression will match.
+	 * A reference to the empty log.
 	 */
-	std::vector<char32_t> characters;
-};
-
-
-}
-namespace pegmatite
-{
-
-/**
- * Out-of-line virtual destructor forces vtable to be emitted in this
- * translation unit only.
- */
-Expr::~Expr()
-{
-}
+	static const Ref empty = 0;
 
-/**
- * Character expression, matches a single character.
- */
-class CharacterExpr : public Expr
-{
-	/**
-	 * The character that will be recognised by this expression.
-	 */
-	char32_t character;
-public:
-	/**
-	 * Constructs a character expression from the specified integer.
-	 */
-	CharacterExpr(char32_t c) : character(c) {}
-	virtual bool parse_non_term(Context &con) const;
-	virtual bool parse_term(Context &con) const;
-	virtual void dump() const;
-	/**
-	 * Returns a range expression that recognises characters in the specified
-	 * range.
-	 */
-	ExprPtr operator-(const CharacterExpr &other);
 	/**
-	 * Returns a range expression that recognises characters in the specified
-	 * range.
+	 * Constructs an empty log, which allocates from `a`, or from the heap if
+	 * `a` is null.
 	 */
-	ExprPtr operator-(char32_t other);
-};
-
-CharacterExprPtr operator "" _E(const char x)
-{
-	return CharacterExprPtr(new CharacterExpr(static_cast<char32_t>(x)));
-}
-CharacterExprPtr operator "" _E(const char32_t x)
-{
-	return CharacterExprPtr(new CharacterExpr(x));
-}
-ExprPtr operator "" _S(const char *x, std::size_t)
-{
-	return set(x);
-}
-ExprPtr operator "" _E(const char *x, std::size_t len)
-{
-	return ExprPtr(new StringExpr(x, len));
-}
-ExprPtr operator-(const CharacterExprPtr &left, const CharacterExprPtr &right)
-{
-	return (*left) - (*right);
-}
-ExprPtr operator-(const CharacterExprPtr &left, char32_t right)
-{
-	return (*left) - right;
-}
-
-ExprPtr::ExprPtr(const CharacterExprPtr &e) :
-	std::shared_ptr<Expr>(std::static_pointer_cast<Expr>(e)) {}
-
-//parsing context
-class Context
-{
-public:
-	//const Rule that parses whitespace
-	const Rule &whitespace_rule;
-
-	//current position
-	ParserPosition position;
-
-	//Error position
-	ParserPosition error_pos;
-
-	//input begin
-	Input::iterator start;
-
-	//input end
-	Input::iterator finish;
-
-	//matches
-	std::vector<ParseMatch> matches;
+	explicit MatchLog(Arena *a = nullptr) :
+		nodes(ArenaAllocator<Node>(a)),
+		reversed(ArenaAllocator<const ParseMatch*>(a)),
+		pending(ArenaAllocator<std::pair<Ref, Ref>>(a)) {}
 
 	/**
-	 * Depth of parsing.  Used for trace expressions.
+	 * Returns a reference to the log consisting of `tail` followed by `m`.
 	 */
-	int depth = 0;
-
-	const ParserDelegate &delegate;
-
-	//constructor
-	Context(Input &i, const Rule &ws, const ParserDelegate &d) :
-		whitespace_rule(ws),
-		position(i),
-		error_pos(i),
-		start(i.begin()),
-		finish(i.end()),
-		delegate(d)
-	{
-	}
-
-	//check if the end is reached
-	bool end() const
-	{
-		return position.it == finish;
-	}
-
-	//get the current symbol
-	char32_t symbol() const
+	Ref append(Ref tail, const ParseMatch &m)
 	{
-		assert(!end());
-		return *position.it;
+		nodes.push_back({ m, tail, empty, empty });
+		return static_cast<Ref>(nodes.size());
 	}
 
-	//set the longest possible error
-	void set_error_pos()
+	/**
+	 * Returns a reference to the log consisting of `tail` followed by the
+	 * matches that were added between `from` and `to`.  `from` must be
+	 * reachable from `to`.
+	 */
+	Ref splice(Ref tail, Ref from, Ref to)
 	{
-		if (position.it > error_pos.it)
+		if (from == to)
 		{
-			error_pos = position;
+			return tail;
 		}
-	}
-
-	//next column
-	void next_col()
-	{
-		++position.it;
-		++position.col;
+		// If the run already follows the tail then it can be reused directly.
+		if (tail == from)
+		{
+			return to;
+		}
+		nodes.push_back({ ParseMatch(), tail, from, to });
+		return static_cast<Ref>(nodes.size());
 	}
 
 	/**
-	 * Consume the specified number of characters in the input.
+	 * Calls `f` with each of the matches in the log ending at `tail`, in the
+	 * order in which they were added.
 	 */
-	void consume(size_t chars)
-	{
-		position.it += chars;
-		position.col += chars;
-	}
-
-	//next line
-	void next_line()
+	template<typename F>
+	void for_each(Ref tail, F f) const
 	{
-		++position.line;
-		position.col = 1;
-	}
-
-	//restore the state
-	void restore(const ParsingState &st)
-	{
-		position = st.position;
-		matches.resize(st.matches);
+		// Walk backwards from the tail, expanding splices.  The pending list
+		// is a stack of runs still to walk, each described by its last node
+		// and the node before its first.
+		reversed.clear();
+		pending.clear();
+		pending.push_back(std::make_pair(tail, empty));
+		while (!pending.empty())
+		{
+			Ref stop = pending.back().second;
+			Ref i = pending.back().first;
+			pending.pop_back();
+			while (i != stop)
+			{
+				const Node &n = nodes[i - 1];
+				if (n.to != empty)
+				{
+					// The spliced run comes after everything before this node,
+					// so walk it first.
+					pending.push_back(std::make_pair(n.prev, stop));
+					pending.push_back(std::make_pair(n.to, n.from));
+					break;
+				}
+				reversed.push_back(&n.match);
+				i = n.prev;
+			}
+		}
+		for (auto i=reversed.rbegin() ; i!=reversed.rend() ; ++i)
+		{
+			f(**i);
+		}
 	}
 
-	//parse non-term rule.
-	bool parse_non_term(const Rule &r);
-
-	//parse term rule.
-	bool parse_term(const Rule &r);
-
-	//parse whitespace terminal
-	bool parse_ws() { return parse_term(whitespace_rule); }
-
-	parse_proc get_parse_proc(const Rule &r) const
+	/**
+	 * Discards the entire log.
+	 */
+	void clear()
 	{
-		return delegate.get_parse_proc(r);
+		ArenaVector<Node>(nodes.get_allocator()).swap(nodes);
+		ArenaVector<const ParseMatch*>(reversed.get_allocator()).swap(reversed);
+		ArenaVector<std::pair<Ref, Ref>>(pending.get_allocator()).swap(pending);
 	}
 
-	//execute all the parse procs
-	void do_parse_procs(void *d) const
+	/**
+	 * Discards the entire log, keeping the memory for reuse.  As with
+	 * `MemoTable::reset()`, the memory is released instead if it is much
+	 * larger than the log that it held, unless it is in an arena.  Resetting
+	 * an empty log does nothing, so the log can be reset both after a cut
+	 * and at the start of the next parse.
+	 */
+	void reset()
 	{
-		for(const auto &m : matches)
+		if (nodes.empty())
+		{
+			return;
+		}
+		if (!nodes.get_allocator().arena &&
+		    (nodes.capacity() > 64 * (nodes.size() + 1)))
 		{
-			parse_proc p = get_parse_proc(*(m.matched_rule));
-			p(m.start, m.finish, d);
+			clear();
+			return;
 		}
+		nodes.clear();
 	}
 
-	/**
-	 * Empty the cache.
-	 */
-	void clear_cache() { cache.clear(); }
-
 private:
 	/**
-	 * The mode for parsing a rule.
+	 * A node in the log.
 	 */
-	enum MatchMode
+	struct Node
 	{
 		/**
-		 * Parse as normal.  If we're left recursing, then try again in reject
-		 * mode.
+		 * The match recorded by this node, if this is not a splice.
 		 */
-		PARSE,
+		ParseMatch match;
 		/**
-		 * Parse as normal only if we are not left recursing.  If we are, then
-		 * fail this rule to force backtracking.
+		 * The reference to the log before this node.
 		 */
-		REJECT
-	};
-
-	//state
-	struct RuleState
-	{
-		//position in source code, relative to start
-		size_t position;
-
-		//mode
-		MatchMode mode;
-
-		//constructor
-		RuleState(size_t ParserPosition = Input::npos, MatchMode m = PARSE) :
-			position(ParserPosition), mode(m) {}
+		Ref prev;
+		/**
+		 * For splices, the reference to the log before the spliced run.
+		 */
+		Ref from;
+		/**
+		 * For splices, the reference to the end of the spliced run.  This is
+		 * `empty` for nodes that record a single match.
+		 */
+		Ref to;
 	};
-	//parse non-term rule.
-	//parse term rule.
-	std::unordered_map<const Rule*, std::vector<RuleState>> rule_states;
-	bool parse_rule(const Rule &r, bool (Context::*parse_func)(const Rule &));
-	bool _parse_non_term(const Rule &r);
+	/**
+	 * The nodes in the log.
+	 */
+	ArenaVector<Node> nodes;
+	/**
+	 * The matches found by `for_each()`, in reverse order.  This and
+	 * `pending` are kept between calls so that their memory is reused.
+	 */
+	mutable ArenaVector<const ParseMatch*> reversed;
+	/**
+	 * The runs of the log still to be walked by `for_each()`.
+	 */
+	mutable ArenaVector<std::pair<Ref, Ref>> pending;
+};
+const MatchLog::Ref MatchLog::empty;
 
-	bool _parse_term(const Rule &r);
+/**
+ * The memo table for the packrat parser.  This maps a rule and a start index
+ * to the result of parsing that rule from that index.
+ *
+ * The keys are stored in a compact open-addressed table with linear probing,
+ * so a lookup usually touches only one or two cache lines, and the results
+ * are stored densely in a separate array.  The table grows as required.  The
+ * parser bounds its size by evicting entries by start position (see
+ * `evict()`).
+ */
+class MemoTable
+{
+public:
+	/**
+	 * Constructs an empty table, which allocates from `a`, or from the heap
+	 * if `a` is null.
+	 */
+	explicit MemoTable(Arena *a = nullptr) :
+		slots(ArenaAllocator<Slot>(a)),
+		entries(ArenaAllocator<Entry>(a)),
+		evicted_filter(ArenaAllocator<uint64_t>(a)),
+		starts(ArenaAllocator<Input::Index>(a)),
+		spare_slots(ArenaAllocator<Slot>(a)),
+		spare_entries(ArenaAllocator<Entry>(a)) {}
 
 	/**
-	 * The key used in the parsing cache.
+	 * A cached result.
 	 */
-	struct CacheKey
+	struct Entry
 	{
 		/**
-		 * The rule for which this cache entry applies.
+		 * Flag indicating whether the rule matched.
 		 */
-		const Rule      *rule;
+		bool ok;
 		/**
-		 * The start address for this rule.
+		 * The position after parsing the rule, if it matched.
 		 */
-		Input::iterator  start;
+		ParserPosition end;
 		/**
-		 * Compare two keys for equality.
+		 * The furthest position at which an error was recorded while parsing
+		 * the rule, whether or not it matched.
 		 */
-		bool operator==(const CacheKey &other) const
-		{
-			return (rule == other.rule) && (start == other.start);
-		}
-	};
-	/**
-	 * The hash calculator for CacheKey objects.  Note that performance of the
-	 * parser is *highly* dependent on the quality of this hash function.
-	 */
-	struct CacheKeyHash
-	{
+		ParserPosition error_pos;
 		/**
-		 * The hash function, xors the hash of the rule and the start index
-		 * together.
+		 * The point in the match log when the rule started.
 		 */
-		size_t operator()(const CacheKey &k) const
-		{
-			std::hash<const Rule*> h;
-			std::hash<Input::Index> hi;
-			return h(k.rule) ^ (hi(k.start.index() << 1));
-		}
+		MatchLog::Ref matches_from;
+		/**
+		 * The point in the match log when the rule finished.  The matches
+		 * between these two points are the rules matched while parsing
+		 * this rule.
+		 */
+		MatchLog::Ref matches_to;
 	};
+
 	/**
-	 * The type for cached entries.  The cache contains the position after
-	 * parsing a rule and the list of rules that were matched.
-	 */
-	typedef std::pair<ParserPosition, std::vector<ParseMatch>> CacheEntry;
-	/*
-	 * The cache.  After each rule is parsed, we cache the result to avoid
-	 * recomputing.  Note that we currently do not cache parse failures.
+	 * Returns the entry for the specified rule and start index, or null if
+	 * there isn't one.  The returned pointer is invalidated by `insert()`.
 	 */
-	std::unordered_map<CacheKey, CacheEntry, CacheKeyHash> cache;
-};
-
-}
-
-namespace{
-
-/**
- * Set expression: matches characters in a set.
- */
-class SetExpr : public Expr
-{
-public:
-	//constructor from ansi string.
-	SetExpr(const char *s)
+	Entry *find(uint32_t rule, Input::Index start)
 	{
-		for(; *s; ++s)
+		if (entries.empty())
 		{
-			_add(static_cast<char32_t>(*s));
+			return nullptr;
+		}
+		for (size_t i=static_cast<size_t>(hash(rule, start)) & mask ; ; i=(i+1) & mask)
+		{
+			Slot &s = slots[i];
+			if (s.start == Input::npos)
+			{
+				return nullptr;
+			}
+			if ((s.start == start) && (s.rule == rule))
+			{
+				return &entries[s.entry];
+			}
 		}
 	}
 
-	//constructor from range.
-	SetExpr(char32_t min, char32_t max)
+	/**
+	 * Returns the entry for the specified rule and start index, creating an
+	 * empty one if there isn't one already.  The returned reference is
+	 * invalidated by the next call to `insert()`.
+	 */
+	Entry &insert(uint32_t rule, Input::Index start)
 	{
-		assert(min >= 0);
-		assert(min <= max);
-		mSetExpr.resize(static_cast<size_t>(max) + 1U);
-		for(; min <= max; ++min)
+		// Keep the load factor below one half, so that probe sequences stay
+		// short.
+		if ((entries.size() + 1) * 2 > slots.size())
 		{
-			mSetExpr[static_cast<size_t>(min)] = true;
+			grow();
+		}
+		for (size_t i=static_cast<size_t>(hash(rule, start)) & mask ; ; i=(i+1) & mask)
+		{
+			Slot &s = slots[i];
+			if (s.start == Input::npos)
+			{
+				s.start = start;
+				s.rule = rule;
+				s.entry = static_cast<uint32_t>(entries.size());
+				entries.emplace_back();
+				return entries.back();
+			}
+			if ((s.start == start) && (s.rule == rule))
+			{
+				return entries[s.entry];
+			}
 		}
 	}
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
-	{
-		return _parse(con);
-	}
+	/**
+	 * Returns the number of entries in the table.
+	 */
+	size_t size() const { return entries.size(); }
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Removes all entries and releases the memory used by the table.
+	 */
+	void clear()
 	{
-		return _parse(con);
+		ArenaVector<Slot>(slots.get_allocator()).swap(slots);
+		ArenaVector<Entry>(entries.get_allocator()).swap(entries);
+		ArenaVector<Input::Index>(starts.get_allocator()).swap(starts);
+		ArenaVector<Slot>(spare_slots.get_allocator()).swap(spare_slots);
+		ArenaVector<Entry>(spare_entries.get_allocator()).swap(spare_entries);
+		mask = 0;
+		evicted_count = 0;
+		evicted_below = 0;
 	}
 
-	virtual void dump() const
+	/**
+	 * Removes all entries, keeping the memory for reuse.  If the table is
+	 * much larger than the number of entries that it held, then it is
+	 * released instead, so that one large parse doesn't make emptying the
+	 * table expensive for all of the small ones after it.  Memory in an arena
+	 * is always kept, as releasing it would not return it to the arena.
+	 * Resetting an empty table only forgets the evicted entries.
+	 */
+	void reset()
 	{
-		fprintf(stderr, "[");
-		char c = 0;
-		for (bool v : mSetExpr)
+		evicted_count = 0;
+		evicted_below = 0;
+		if (entries.empty())
 		{
-			if (v)
-				fprintf(stderr, "%c", c);
-			c++;
+			return;
 		}
-		fprintf(stderr, "]");
-	}
-
-private:
-	//set is kept as an array of flags, for quick access
-	std::vector<bool> mSetExpr;
-
-	//add character
-	void _add(char32_t i)
-	{
-		if (i >= mSetExpr.size())
+		if (!slots.get_allocator().arena &&
+		    (slots.size() > 64 * (entries.size() + 1)))
 		{
-			mSetExpr.resize(i + 1);
+			clear();
+			return;
 		}
-		mSetExpr[i] = true;
+		std::fill(slots.begin(), slots.end(), Slot());
+		entries.clear();
 	}
 
-	//internal parse
-	bool _parse(Context &con) const
+	/**
+	 * Evicts entries to reduce the table to at most `keep` entries.  Entries
+	 * that start before `limit` are always evicted, and then those that start
+	 * earliest, as they are the least likely to be needed again.  Returns the
+	 * number of entries evicted.
+	 */
+	size_t evict(Input::Index limit, size_t keep)
 	{
-		if (!con.end())
+		// Find the start index below which entries must be evicted.
+		starts.clear();
+		for (const Slot &s : slots)
 		{
-			size_t ch = con.symbol();
-			if (ch < mSetExpr.size() && mSetExpr[ch])
+			if ((s.start != Input::npos) && (s.start >= limit))
 			{
-				con.next_col();
-				return true;
+				starts.push_back(s.start);
 			}
 		}
-		con.set_error_pos();
-		return false;
-	}
-};
-
-/**
- * Adaptor that modifies the type of the iterator.  This lets us use iterators
- * with things that expect char or whcar_t iterators (as long as casts work
- * appropriately).
- */
-template<typename Src, typename Out, typename In>
-class IteratorAdaptor : public std::iterator<std::bidirectional_iterator_tag, Out>
-{
-		Src s;
-		public:
-		inline IteratorAdaptor(Src src) : s(src) {}
-		inline IteratorAdaptor() {}
-		inline Out operator*() const { return static_cast<Out>(*s); }
-		inline IteratorAdaptor &operator++()
-		{
-			++s;
-			return *this;
-		}
-		inline IteratorAdaptor<Src, Out,In> operator++(int /*dummy*/)
-		{
-			auto copy = *this;
-			s++;
-			return copy;
-		}
-		inline IteratorAdaptor<Src, Out,In> &operator--()
-		{
-			--s;
-			return *this;
-		}
-		inline bool operator==(const IteratorAdaptor<Src, Out,In> &other) const
-		{
-			return s == other.s;
-		}
-		inline bool operator!=(const IteratorAdaptor<Src, Out,In> &other) const
+		Input::Index cutoff = limit;
+		// The number of entries starting at the cutoff that may be kept.
+		// Many entries can share a start index, so keeping all of them could
+		// leave more than `keep`, and the table would be rebuilt again on the
+		// next insertion.
+		size_t keep_at_cutoff = SIZE_MAX;
+		bool evicted_at_cutoff = false;
+		if (starts.size() > keep)
 		{
-			return s != other.s;
+			auto nth = starts.begin() +
+				static_cast<std::ptrdiff_t>(starts.size() - keep);
+			std::nth_element(starts.begin(), nth, starts.end());
+			cutoff = *nth;
+			size_t above = static_cast<size_t>(std::count_if(nth, starts.end(),
+				[=](Input::Index i) { return i > cutoff; }));
+			keep_at_cutoff = keep - above;
 		}
-		inline bool operator>(const IteratorAdaptor<Src, Out,In> &other) const
+		// Rebuild the table with the survivors, swapping the old table with
+		// the spare one.
+		size_t before = entries.size();
+		spare_slots.assign(slots.size(), Slot());
+		spare_slots.swap(slots);
+		spare_entries.clear();
+		spare_entries.swap(entries);
+		for (const Slot &s : spare_slots)
 		{
-			return s > other.s;
+			if (s.start == Input::npos)
+			{
+				continue;
+			}
+			if (s.start == cutoff)
+			{
+				if (keep_at_cutoff == 0)
+				{
+					evicted_at_cutoff = true;
+					remember_eviction(s.rule, s.start);
+					continue;
+				}
+				keep_at_cutoff--;
+			}
+			else if (s.start < cutoff)
+			{
+				remember_eviction(s.rule, s.start);
+				continue;
+			}
+			size_t i = static_cast<size_t>(hash(s.rule, s.start)) & mask;
+			while (slots[i].start != Input::npos)
+			{
+				i = (i + 1) & mask;
+			}
+			slots[i] = s;
+			slots[i].entry = static_cast<uint32_t>(entries.size());
+			entries.push_back(std::move(spare_entries[s.entry]));
 		}
-		inline bool operator<(const IteratorAdaptor<Src, Out,In> &other) const
+		// If some of the entries at the cutoff were evicted, then lookups at
+		// the cutoff must consult the filter too.
+		evicted_below = std::max(evicted_below,
+			evicted_at_cutoff ? cutoff + 1 : cutoff);
+		return before - entries.size();
+	}
+
+	/**
+	 * Returns true if an entry for the specified rule and start index may
+	 * have been evicted.  This uses a small Bloom filter, which is reset when
+	 * it fills, so the result is an estimate.
+	 */
+	bool was_evicted(uint32_t rule, Input::Index start) const
+	{
+		if ((evicted_count == 0) || (start >= evicted_below))
 		{
-			return s < other.s;
+			return false;
 		}
-};
+		uint64_t h = hash(rule, start);
+		return test_bit(h) && test_bit(h >> 32);
+	}
 
-/**
- * Preform a regular expression match, starting at `begin` and trying to match
- * up to `end`.  Returns true if the regular expression matches the input,
- * false otherwise.  If there is a match, then `length` will be set to the
- * length of the match.
- */
-template <typename T>
-bool regexMatch(Input::iterator begin,
-                Input::iterator end,
-                const std::basic_regex<T> &r,
-                size_t &length)
-{
-	typedef IteratorAdaptor<Input::iterator, T, char32_t> Iterator;
-	std::match_results<Iterator> match;
-	Iterator b(begin), e(end);
-	if (std::regex_search(b, e, match, r, std::regex_constants::match_continuous))
+private:
+	/**
+	 * A slot in the hash table.
+	 */
+	struct Slot
 	{
-		length = static_cast<size_t>(match.length());
-		return true;
-	}
-	return false;
-}
+		/**
+		 * The index at which the rule was parsed, or npos if this slot is
+		 * empty.
+		 */
+		Input::Index start = Input::npos;
+		/**
+		 * The ID of the rule that was parsed.
+		 */
+		uint32_t rule = 0;
+		/**
+		 * The index of the result in `entries`.
+		 */
+		uint32_t entry = 0;
+	};
+	/**
+	 * The hash table.  The size is always zero or a power of two.
+	 */
+	ArenaVector<Slot> slots;
+	/**
+	 * The cached results, in the order in which they were inserted.
+	 */
+	ArenaVector<Entry> entries;
+	/**
+	 * The size of the table minus one, used to map hashes to slots.
+	 */
+	size_t mask = 0;
+	/**
+	 * The number of bits in the filter of evicted keys.
+	 */
+	static const size_t filter_bits = 1 << 17;
+	/**
+	 * Bloom filter recording the keys of evicted entries.
+	 */
+	ArenaVector<uint64_t> evicted_filter;
+	/**
+	 * The number of keys added to the filter since it was last reset.
+	 */
+	size_t evicted_count = 0;
+	/**
+	 * The highest start index below which entries have been evicted.  Entries
+	 * starting after this have never been evicted.
+	 */
+	Input::Index evicted_below = 0;
+	/**
+	 * The start indexes of the entries considered by `evict()`.  This is
+	 * kept between evictions so that its memory is reused.
+	 */
+	ArenaVector<Input::Index> starts;
+	/**
+	 * The table from before the last eviction.  The table is rebuilt into
+	 * this on the next eviction, so that evicting doesn't allocate new tables
+	 * from the arena each time.
+	 */
+	ArenaVector<Slot> spare_slots;
+	/**
+	 * The entries from before the last eviction.
+	 */
+	ArenaVector<Entry> spare_entries;
 
-/**
- * Matches characters that correspond to a given regular expression.
- */
-template<typename CharTy>
-class RegexExpr : public Expr
-{
-	std::basic_regex<CharTy> r;
-	bool parse(Context &con) const
+	/**
+	 * Adds a key to the filter of evicted entries, resetting the filter first
+	 * if it is too full to be useful.
+	 */
+	void remember_eviction(uint32_t rule, Input::Index start)
 	{
-		size_t length;
-		if (regexMatch(con.position.it, con.finish, r, length))
+		if ((evicted_count == 0) || (evicted_count > filter_bits / 16))
 		{
-			con.consume(length);
-			return true;
+			evicted_filter.assign(filter_bits / 64, 0);
+			evicted_count = 0;
 		}
-		con.set_error_pos();
-		return false;
+		evicted_count++;
+		uint64_t h = hash(rule, start);
+		set_bit(h);
+		set_bit(h >> 32);
 	}
-public:
-	RegexExpr(const CharTy *s) : r(s, std::regex_constants::optimize) {}
-	RegexExpr(const CharTy *s, size_t count) : r(s, count, std::regex_constants::optimize) {}
-
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Sets the bit in the filter selected by the low bits of `h`.
+	 */
+	void set_bit(uint64_t h)
 	{
-		return parse(con);
+		size_t bit = static_cast<size_t>(h) & (filter_bits - 1);
+		evicted_filter[bit / 64] |= uint64_t(1) << (bit % 64);
+	}
+	/**
+	 * Tests the bit in the filter selected by the low bits of `h`.
+	 */
+	bool test_bit(uint64_t h) const
+	{
+		size_t bit = static_cast<size_t>(h) & (filter_bits - 1);
+		return (evicted_filter[bit / 64] >> (bit % 64)) & 1;
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Hashes a rule ID and start index.  Entries for the same rule at nearby
+	 * indexes, and for different rules at the same index, are very common, so
+	 * this uses a full 64-bit mix (the finaliser from MurmurHash3) rather
+	 * than simply combining the two values.
+	 */
+	static uint64_t hash(uint32_t rule, Input::Index start)
 	{
-		return parse(con);
+		uint64_t h = static_cast<uint64_t>(start) ^
+		             (static_cast<uint64_t>(rule) << 40) ^
+		             (static_cast<uint64_t>(rule) >> 24);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
 	}
 
-	virtual void dump() const
+	/**
+	 * Doubles the size of the hash table and reinserts all of the keys.
+	 */
+	void grow()
 	{
-		fprintf(stderr, "<regex>");
+		ArenaVector<Slot> old(slots.get_allocator());
+		old.swap(slots);
+		slots.resize(old.empty() ? 64 : old.size() * 2);
+		mask = slots.size() - 1;
+		for (const Slot &s : old)
+		{
+			if (s.start == Input::npos)
+			{
+				continue;
+			}
+			size_t i = static_cast<size_t>(hash(s.rule, s.start)) & mask;
+			while (slots[i].start != Input::npos)
+			{
+				i = (i + 1) & mask;
+			}
+			slots[i] = s;
+		}
 	}
 };
 
-
-//base class for unary expressions
-class UnaryExpr : public Expr
+/**
+ * The operations in the bytecode that rules are compiled into (see
+ * `Context::run()`).  Each corresponds to a label in the interpreter, so the
+ * order must match the dispatch table there.
+ */
+enum Opcode : uint8_t
 {
-public:
-	UnaryExpr(const ExprPtr e) : expr(e) { }
-protected:
-	const ExprPtr expr;
+	/// Match the character in the argument.
+	OP_CHAR,
+	/// Match any character.
+	OP_ANY,
+	/// Match a character in the set expression.
+	OP_SET,
+	/// Match characters in the set expression until one doesn't match.
+	OP_SPAN,
+	/// Match the string expression.
+	OP_STRING,
+	/// Parse the expression as a terminal.
+	OP_EXPR_TERM,
+	/// Parse the expression as a non-terminal.
+	OP_EXPR_NON_TERM,
+	/// Parse the rule as a terminal.
+	OP_RULE_TERM,
+	/// Parse the rule as a non-terminal.
+	OP_RULE_NON_TERM,
+	/// Parse whitespace.  This never fails.
+	OP_WS,
+	/// Advance the position to the start of the next line.
+	OP_NEWLINE,
+	/// Save a backtrack point.  If parsing fails, restore it and continue at
+	/// the instruction in the argument.
+	OP_CHOICE,
+	/// Continue at the first alternative of a choice, from the one in the
+	/// argument onwards, that can start with the next character, or fail if
+	/// there isn't one.
+	OP_DISPATCH,
+	/// Save a backtrack point for an and-predicate.  If parsing fails,
+	/// restore it and keep failing.
+	OP_AND,
+	/// Save a backtrack point for a not-predicate.  If parsing fails,
+	/// restore it and continue at the instruction in the argument.
+	OP_NOT,
+	/// Discard the most recent backtrack point and continue at the
+	/// instruction in the argument.
+	OP_COMMIT,
+	/// Restore the backtrack point saved by `OP_AND`.
+	OP_AND_END,
+	/// Restore the backtrack point saved by `OP_NOT` and fail.
+	OP_NOT_END,
+	/// Finish parsing the rule successfully.
+	OP_RETURN
 };
 
+struct Dispatch;
 
-//terminal
-class TerminalExpr : public UnaryExpr
+/**
+ * An instruction in the bytecode.
+ */
+struct Instruction
 {
-public:
-	//constructor.
-	TerminalExpr(const ExprPtr e) :
-		UnaryExpr(e)
-	{
-	}
-
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	//the operation
+	Opcode op;
+	//the character, the instruction to jump to or the first alternative
+	uint32_t arg;
+	//the operand of instructions that parse an expression or a rule
+	union
 	{
-		return expr->parse_term(con);
-	}
+		//the expression
+		const Expr *expr;
+		//the rule
+		const Rule *rule;
+		//the table for choosing an alternative
+		const Dispatch *dispatch;
+	};
+};
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
-	{
-		return expr->parse_term(con);
-	}
+/**
+ * The table that `OP_DISPATCH` uses to find the alternatives of a choice
+ * that can start with the next character.  Alternative `i` is bit `i` of
+ * each mask.  Choices can have more alternatives than there are bits, so the
+ * last bit stands for all of the rest, and is always set.
+ */
+struct Dispatch
+{
+	//the number of characters that have their own entry in the table
+	static const char32_t limit = 256;
+	//the last alternative that has its own bit
+	static const uint32_t last_bit = 63;
+	//for each character below the limit, the alternatives that it can start
+	uint64_t characters[limit] = {};
+	//the alternatives that characters from the limit upwards can start
+	uint64_t others = 0;
+	//the alternatives that can match at the end of the input
+	uint64_t end = 0;
+	//the first instruction of each alternative
+	std::vector<uint32_t> entries;
 
-	virtual void dump() const
+	/**
+	 * Returns the index of the first alternative, from `from` onwards, that
+	 * can start with the character `c`, or with the end of the input if
+	 * `at_end` is true.  Returns the number of alternatives if none can.
+	 */
+	uint32_t select(uint32_t from, bool at_end, char32_t c) const
 	{
-		expr->dump();
+		if (from >= last_bit)
+		{
+			return from;
+		}
+		uint64_t viable = at_end ? end : (c < limit ? characters[c] : others);
+		viable &= ~0ULL << from;
+		if (!viable)
+		{
+			return static_cast<uint32_t>(entries.size());
+		}
+#ifdef __GNUC__
+		return static_cast<uint32_t>(__builtin_ctzll(viable));
+#else
+		uint32_t i = 0;
+		while (!(viable & 1))
+		{
+			viable >>= 1;
+			i++;
+		}
+		return i;
+#endif
 	}
-
 };
 
+/**
+ * String expression.  Matches a sequence of characters.
+ */
+class StringExpr : public Expr
+{
+public:
+	/**
+	 * Returns a new string expression recognising the specified string.
+	 */
+	StringExpr(const char *s) : characters(s, s + strlen(s)) {}
+	/**
+	 * Returns a new string expression recognising the specified string.
+	 */
+	StringExpr(const char *s, std::size_t length) : characters(s, s + length) {}
+	/**
+	 * Returns a new string expression recognising the specified characters.
+	 */
+	StringExpr(const std::vector<char32_t> &c) : characters(c) {}
+	/**
+	 * Returns the characters that this expression matches.
+	 */
+	const std::vector<char32_t> &chars() const { return characters; }
+	virtual bool parse_non_term(Context &con) const;
+	virtual bool parse_term(Context &con) const;
+	virtual void compile(ProgramBuilder &b, bool term) const;
+	virtual void first(FirstSet &set, bool term) const;
+	virtual void dump() const;
+private:
+	/**
+	 * The characters that this expression will match.
+	 */
+	std::vector<char32_t> characters;
+};
 
-//loop 0
-class Loop0Expr : public UnaryExpr
-{
-public:
-	//constructor.
-	Loop0Expr(const ExprPtr e) :
-		UnaryExpr(e)
-	{
-	}
-
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
-	{
-		//if parsing of the first fails, restore the context and stop
-		con.parse_ws();
-		ParsingState st(con);
-		if (!expr->parse_non_term(con))
-		{
-			con.restore(st);
-			return true;
-		}
 
-		//parse the rest
-		for(;;)
-		{
-			con.parse_ws();
-			ParsingState s(con);
-			if (!expr->parse_non_term(con))
-			{
-				con.restore(s);
-				break;
-			}
-		}
+}
+namespace pegmatite
+{
 
-		return true;
-	}
+/**
+ * Out-of-line virtual destructor forces vtable to be emitted in this
+ * translation unit only.
+ */
+Expr::~Expr()
+{
+}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+/**
+ * The bytecode for parsing the expression of a rule, either as a terminal or
+ * as a non-terminal.  Rules that the expression refers to are parsed with
+ * `Context::parse_term()` or `Context::parse_non_term()`, so that they are
+ * memoized and their matches recorded, but everything between them is a
+ * flat sequence of instructions.
+ */
+class Program
+{
+public:
+	//the instructions
+	std::vector<Instruction> code;
+	/**
+	 * If the program consists of a single instruction, the expression that
+	 * it matches.
+	 * Running the interpreter for these would only add overhead, so the
+	 * parser walks the expression instead.
+	 */
+	const Expr *direct = nullptr;
+	/**
+	 * A hash of the instructions, which identifies the program to code
+	 * generated from it (see `generateParser()`).
+	 */
+	uint64_t fingerprint = 0;
+	/**
+	 * Expressions created while compiling, such as strings made by joining
+	 * consecutive literals, which the instructions refer to.
+	 */
+	std::vector<ExprPtr> owned;
+	//the tables for the `OP_DISPATCH` instructions
+	std::vector<std::unique_ptr<Dispatch>> tables;
+};
+
+/**
+ * The characters that can start a match of an expression (see
+ * `Expr::first()`).  Sets may contain characters that can't start a match,
+ * but never leave out ones that can.
+ */
+class FirstSet
+{
+public:
+	struct Alternative;
+	//constructor, for a computation that has entered the rules in `a`
+	FirstSet(std::vector<const Rule*> &a) : active(&a) {}
+	//the characters below the dispatch table's limit that can start a match
+	std::bitset<Dispatch::limit> characters;
+	//true if characters above the limit can start a match
+	bool others = false;
+	//true if the expression can match without consuming the next character
+	bool nullable = false;
+	/**
+	 * The choice whose set is being computed, if its alternatives are being
+	 * collected in `alternatives`, with nested choices flattened.
+	 */
+	const Expr *split = nullptr;
+	//the alternatives of `split`
+	std::vector<Alternative> *alternatives = nullptr;
+
+	//adds the character c
+	void add(char32_t c)
 	{
-		//if parsing of the first fails, restore the context and stop
-		ParsingState st(con);
-		if (!expr->parse_term(con))
+		if (c < Dispatch::limit)
 		{
-			con.restore(st);
-			return true;
+			characters.set(c);
 		}
-
-		//parse the rest until no more parsing is possible
-		for(;;)
+		else
 		{
-			ParsingState s(con);
-			if (!expr->parse_term(con))
-			{
-				con.restore(s);
-				break;
-			}
+			others = true;
 		}
-
-		return true;
 	}
-	virtual void dump() const
+	//adds the characters in another set, but not whether it's nullable
+	void add(const FirstSet &other)
 	{
-		fprintf(stderr, "*( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		characters |= other.characters;
+		others |= other.others;
 	}
-};
-
-
-//loop 1
-class Loop1Expr : public UnaryExpr
-{
-public:
-	Loop1Expr(const ExprPtr e) : UnaryExpr(e) { }
-
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	//adds every character
+	void add_all()
 	{
-		//parse the first; if the first fails, stop
-		con.parse_ws();
-		if (!expr->parse_non_term(con)) return false;
-
-		//parse the rest until no more parsing is possible
-		for(;;)
-		{
-			con.parse_ws();
-			ParsingState st(con);
-			if (!expr->parse_non_term(con))
-			{
-				con.restore(st);
-				break;
-			}
-		}
-
-		return true;
+		characters.set();
+		others = true;
 	}
-
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	//makes the set say nothing about the expression
+	void unknown()
 	{
-		//parse the first; if the first fails, stop
-		if (!expr->parse_term(con)) return false;
-
-		//parse the rest until no more parsing is possible
-		for(;;)
-		{
-			ParsingState st(con);
-			if (!expr->parse_term(con))
-			{
-				con.restore(st);
-				break;
-			}
-		}
-
-		return true;
+		add_all();
+		nullable = true;
 	}
-
-	virtual void dump() const
+	//returns true if the set contains the character c
+	bool contains(char32_t c) const
 	{
-		fprintf(stderr, "+( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		return (c < Dispatch::limit) ? characters.test(c) : others;
 	}
+	//returns true if there are places where the expression can't match
+	bool excludes() const
+	{
+		return !nullable && !(others && characters.all());
+	}
+	/**
+	 * Returns the set for the expression `e`.
+	 */
+	FirstSet of(const Expr &e, bool term) const;
+	/**
+	 * Adds the alternative `e` of the choice `choice` to this set.
+	 */
+	void alternative(const Expr &choice, const Expr &e, bool term);
+	/**
+	 * Adds the set for the rule `r`, computing it if necessary.
+	 */
+	void rule(const Rule &r, bool term);
+private:
+	//the rules whose sets are being computed, which refer to themselves
+	std::vector<const Rule*> *active;
 };
 
+/**
+ * An alternative of a choice, with the set of characters that can start it.
+ */
+struct FirstSet::Alternative
+{
+	//the expression
+	const Expr *expr;
+	//the characters that can start it
+	FirstSet first;
+};
 
-//optional
-class OptionalExpr : public UnaryExpr
+/**
+ * Compiles expressions into a `Program` (see `Expr::compile()`).
+ */
+class ProgramBuilder
 {
 public:
-	OptionalExpr(const ExprPtr e) : UnaryExpr(e) { }
+	//constructor
+	ProgramBuilder(Program &p) : program(p) {}
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Appends an instruction and returns its index.
+	 */
+	uint32_t emit(Opcode op, uint32_t arg = 0)
 	{
-		ParsingState st(con);
-		if (!expr->parse_non_term(con)) con.restore(st);
-		return true;
+		Instruction i;
+		i.op = op;
+		i.arg = arg;
+		i.expr = nullptr;
+		program.code.push_back(i);
+		return static_cast<uint32_t>(program.code.size() - 1);
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Appends an instruction that parses the expression `e`.
+	 */
+	void emit(Opcode op, const Expr &e)
 	{
-		ParsingState st(con);
-		if (!expr->parse_term(con)) con.restore(st);
-		return true;
+		program.code[emit(op)].expr = &e;
 	}
 
-	virtual void dump() const
+	/**
+	 * Appends an instruction that parses the rule `r`.
+	 */
+	void emit(Opcode op, const Rule &r)
 	{
-		fprintf(stderr, "-( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		program.code[emit(op)].rule = std::addressof(r);
 	}
-};
-
-
-//and
-// Try to parse expr, succeed iff the parse succeeds, but do not
-// consume any input.
-class AndExpr : public UnaryExpr
-{
-public:
-	AndExpr(const ExprPtr e) : UnaryExpr(e) { }
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Returns the index of the next instruction.
+	 */
+	uint32_t here() const
 	{
-		ParsingState st(con);
-		bool ok = expr->parse_non_term(con);
-		con.restore(st);
-		return ok;
+		return static_cast<uint32_t>(program.code.size());
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Returns the index of the next instruction, which will be the target of
+	 * a jump.
+	 */
+	uint32_t label()
 	{
-		ParsingState st(con);
-		bool ok = expr->parse_term(con);
-		con.restore(st);
-		return ok;
+		target = here();
+		return target;
 	}
 
-	virtual void dump() const
+	/**
+	 * Sets the jump target of the instruction at index `i` to the next
+	 * instruction.
+	 */
+	void patch(uint32_t i)
 	{
-		fprintf(stderr, "&( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		program.code[i].arg = label();
 	}
-};
-
-
-//not
-class NotExpr : public UnaryExpr
-{
-public:
-	NotExpr(const ExprPtr e) : UnaryExpr(e) { }
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Keeps `e` alive for as long as the program and returns it.
+	 */
+	const Expr &own(Expr *e)
 	{
-		ParsingState st(con);
-		bool ok = !expr->parse_non_term(con);
-		con.restore(st);
-		return ok;
+		program.owned.emplace_back(e);
+		return *e;
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Appends an instruction that matches the character `c`.
+	 */
+	void character(char32_t c, bool term)
 	{
-		ParsingState st(con);
-		bool ok = !expr->parse_term(con);
-		con.restore(st);
-		return ok;
+		if (!join(&c, 1, term))
+		{
+			emit(OP_CHAR, static_cast<uint32_t>(c));
+		}
 	}
 
-	virtual void dump() const
+	/**
+	 * Appends an instruction that matches the string `s`.
+	 */
+	void string(const StringExpr &s, bool term)
 	{
-		fprintf(stderr, "!( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		if (!join(s.chars().data(), s.chars().size(), term))
+		{
+			emit(OP_STRING, s);
+		}
 	}
-};
 
+	/**
+	 * Compiles the choice `e`.  Nested choices are flattened into one list
+	 * of alternatives, tried in order.  If the next character rules some of
+	 * them out, the choice starts with a dispatch table that skips to the
+	 * first that can match, and each alternative that fails goes back to
+	 * the table to find the next.  A choice between single characters,
+	 * such as `'a'_E | 'b' | 'c'`, becomes a single set.
+	 */
+	void choice(const Expr &e, bool term);
 
-//newline
-class NewlineExpr : public UnaryExpr
-{
-public:
-	NewlineExpr(const ExprPtr e) : UnaryExpr(e) { }
-
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Compiles the expression `e`.
+	 */
+	void expr(const ExprPtr &e, bool term)
 	{
-		if (!expr->parse_non_term(con)) return false;
-		con.next_line();
-		return true;
+		e->compile(*this, term);
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Compiles a loop that parses `e` until it fails.  Non-terminals parse
+	 * whitespace before each iteration.
+	 */
+	void repeat(const ExprPtr &e, bool term)
 	{
-		if (!expr->parse_term(con)) return false;
-		con.next_line();
-		return true;
+		uint32_t loop = label();
+		if (!term)
+		{
+			emit(OP_WS);
+		}
+		uint32_t choice = emit(OP_CHOICE);
+		expr(e, term);
+		// A set consumes nothing when it fails, so a terminal loop over one
+		// doesn't need a backtrack point for each iteration.
+		if (term && (here() == choice + 2) &&
+		    (program.code[choice + 1].op == OP_SET))
+		{
+			program.code[choice] = program.code[choice + 1];
+			program.code[choice].op = OP_SPAN;
+			program.code.pop_back();
+			return;
+		}
+		emit(OP_COMMIT, loop);
+		patch(choice);
 	}
 
-	virtual void dump() const
+private:
+	//the program being built
+	Program &program;
+	//the most recent instruction that is the target of a jump
+	uint32_t target = UINT32_MAX;
+
+	/**
+	 * Joins `length` characters to the literal in the previous instruction,
+	 * if this is a terminal and nothing jumps between them.  Returns false if
+	 * they can't be joined.
+	 */
+	bool join(const char32_t *chars, size_t length, bool term)
 	{
-		fprintf(stderr, "nl( ");
-		expr->dump();
-		fprintf(stderr, " )");
+		std::vector<Instruction> &code = program.code;
+		if (!term || code.empty() || (here() == target))
+		{
+			return false;
+		}
+		Instruction &prev = code.back();
+		std::vector<char32_t> joined;
+		if (prev.op == OP_CHAR)
+		{
+			joined.push_back(static_cast<char32_t>(prev.arg));
+		}
+		else if (prev.op == OP_STRING)
+		{
+			joined = static_cast<const StringExpr*>(prev.expr)->chars();
+		}
+		else
+		{
+			return false;
+		}
+		joined.insert(joined.end(), chars, chars + length);
+		prev.op = OP_STRING;
+		prev.arg = 0;
+		prev.expr = &own(new StringExpr(joined));
+		return true;
 	}
 };
 
+void Expr::compile(ProgramBuilder &b, bool term) const
+{
+	b.emit(term ? OP_EXPR_TERM : OP_EXPR_NON_TERM, *this);
+}
 
-//base class for binary expressions
-class BinaryExpr : public Expr
+void Expr::first(FirstSet &set, bool) const
+{
+	set.unknown();
+}
+
+void Expr::rules(std::vector<const Rule*> &) const
+{
+}
+
+/**
+ * Character expression, matches a single character.
+ */
+class CharacterExpr : public Expr
 {
+	/**
+	 * The character that will be recognised by this expression.
+	 */
+	char32_t character;
 public:
-	BinaryExpr(const ExprPtr &l, const ExprPtr &r) :
-		left(l), right(r) { }
-protected:
-	const ExprPtr left, right;
+	/**
+	 * Constructs a character expression from the specified integer.
+	 */
+	CharacterExpr(char32_t c) : character(c) {}
+	virtual bool parse_non_term(Context &con) const;
+	virtual bool parse_term(Context &con) const;
+	virtual void compile(ProgramBuilder &b, bool term) const;
+	virtual void first(FirstSet &set, bool term) const;
+	virtual void dump() const;
+	/**
+	 * Returns a range expression that recognises characters in the specified
+	 * range.
+	 */
+	ExprPtr operator-(const CharacterExpr &other);
+	/**
+	 * Returns a range expression that recognises characters in the specified
+	 * range.
+	 */
+	ExprPtr operator-(char32_t other);
 };
 
+CharacterExprPtr operator "" _E(const char x)
+{
+	return CharacterExprPtr(new CharacterExpr(static_cast<char32_t>(x)));
+}
+CharacterExprPtr operator "" _E(const char32_t x)
+{
+	return CharacterExprPtr(new CharacterExpr(x));
+}
+ExprPtr operator "" _S(const char *x, std::size_t)
+{
+	return set(x);
+}
+ExprPtr operator "" _E(const char *x, std::size_t len)
+{
+	return ExprPtr(new StringExpr(x, len));
+}
+ExprPtr operator-(const CharacterExprPtr &left, const CharacterExprPtr &right)
+{
+	return (*left) - (*right);
+}
+ExprPtr operator-(const CharacterExprPtr &left, char32_t right)
+{
+	return (*left) - right;
+}
+
+ExprPtr::ExprPtr(const CharacterExprPtr &e) :
+	std::shared_ptr<Expr>(std::static_pointer_cast<Expr>(e)) {}
 
-//sequence
-class SequenceExpr : public BinaryExpr
+/**
+ * The ID to assign to the next rule that is constructed.
+ */
+static std::atomic<uint32_t> next_rule_id(0);
+
+/**
+ * The rules of a grammar, numbered densely from zero, so that the parser can
+ * keep the state of each rule in an array sized for the grammar rather than
+ * for every rule in the program.  A layout is built by walking the
+ * expressions reachable from the root rule and the whitespace rule.
+ *
+ * The rules of a grammar are usually constructed together, so their IDs fall
+ * in a narrow range, and the index of each rule is found by looking its ID
+ * up in a table covering that range.
+ */
+class GrammarLayout
 {
 public:
-	SequenceExpr(const ExprPtr left, const ExprPtr right) : BinaryExpr(left, right) {}
+	/**
+	 * The index returned for rules that are not part of the grammar.
+	 */
+	static const uint32_t npos = UINT32_MAX;
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	/**
+	 * Numbers the rules reachable from `root` and `ws`.
+	 */
+	GrammarLayout(const Rule &root, const Rule &ws)
 	{
-		if (!left->parse_non_term(con)) return false;
-		con.parse_ws();
-		return right->parse_non_term(con);
+		std::vector<const Rule*> rules;
+		std::vector<const Rule*> referenced;
+		std::unordered_set<const Rule*> seen;
+		auto add = [&](const Rule *r)
+		{
+			if (seen.insert(r).second)
+			{
+				rules.push_back(r);
+			}
+		};
+		add(std::addressof(root));
+		add(std::addressof(ws));
+		for (size_t i=0 ; i<rules.size() ; i++)
+		{
+			referenced.clear();
+			rules[i]->expr->rules(referenced);
+			for (const Rule *r : referenced)
+			{
+				add(r);
+			}
+		}
+		uint32_t last_id = 0;
+		first_id = UINT32_MAX;
+		for (const Rule *r : rules)
+		{
+			first_id = std::min(first_id, r->id);
+			last_id = std::max(last_id, r->id);
+		}
+		indexes.assign(last_id - first_id + 1, npos);
+		for (const Rule *r : rules)
+		{
+			indexes[r->id - first_id] = count++;
+		}
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	/**
+	 * Returns the index of rule `r`, or `npos` if it is not part of the
+	 * grammar.
+	 */
+	uint32_t index(const Rule &r) const
 	{
-		if (!left->parse_term(con)) return false;
-		return right->parse_term(con);
+		uint32_t offset = r.id - first_id;
+		return (offset < indexes.size()) ? indexes[offset] : npos;
 	}
 
-	virtual void dump() const
-	{
-		left->dump();
-		fprintf(stderr, " >> ");
-		right->dump();
-	}
+	/**
+	 * Returns the number of rules in the grammar.
+	 */
+	uint32_t size() const { return count; }
+
+private:
+	//the lowest ID of a rule in the grammar
+	uint32_t first_id;
+	//the index of each rule, by ID relative to `first_id`
+	std::vector<uint32_t> indexes;
+	//the number of rules in the grammar
+	uint32_t count = 0;
 };
 
+const uint32_t GrammarLayout::npos;
 
-//choice
-class ChoiceExpr : public BinaryExpr
+namespace {
+/**
+ * A backtrack point (see `Context::pin()`).
+ */
+struct BacktrackPoint
 {
-public:
-	ChoiceExpr(const ExprPtr &left, const ExprPtr &right) :
-		BinaryExpr(left, right) {}
+	//the index of the backtrack point
+	Input::Index index;
+	//flag indicating whether this is the start of a match
+	bool match;
+};
+/**
+ * The state of a rule that is currently being parsed.  If the rule is
+ * reached again at the same position then it is left recursive, and the
+ * inner invocation returns the seed: the result of the previous attempt
+ * at parsing the rule (initially a failure).  The outer invocation then
+ * grows the seed by parsing the rule again until it stops getting longer
+ * (Warth et al, "Packrat Parsers Can Support Left Recursion").
+ */
+struct RuleState
+{
+	//position in source code, relative to start
+	size_t position;
+	//depth of the invocation, in rules being parsed
+	uint32_t depth;
+	//flag indicating whether the rule has been reached left recursively
+	bool left_recursive;
+	//flag indicating whether the seed is a successful parse
+	bool seed_ok;
+	//end of the seed
+	ParserPosition seed_end;
+	//the matches recorded by the seed
+	MatchLog::Ref seed_from;
+	//the end of the matches recorded by the seed
+	MatchLog::Ref seed_to;
+	//the enclosing invocation of the same rule
+	RuleState *outer;
 
-	virtual bool parse_non_term(Context &con) const
-	{
-		ParsingState st(con);
-		if (left->parse_non_term(con)) return true;
-		con.restore(st);
-		return right->parse_non_term(con);
-	}
+	//constructor
+	RuleState(size_t p, uint32_t d, RuleState *o) :
+		position(p), depth(d), left_recursive(false), seed_ok(false),
+		outer(o) {}
+};
 
-	virtual bool parse_term(Context &con) const
-	{
-		ParsingState st(con);
-		if (left->parse_term(con)) return true;
-		con.restore(st);
-		return right->parse_term(con);
-	}
+/**
+ * A backtrack point saved by the bytecode interpreter.
+ */
+struct VMFrame
+{
+	//the position to restore
+	ParserPosition position;
+	//the point in the match log to restore
+	MatchLog::Ref matches;
+	//the number of cuts that had been parsed when the point was saved
+	uint64_t cuts;
+	//the instruction to continue at if the point is restored after a failure
+	uint32_t alt;
+	//the instruction that saved the point
+	Opcode kind;
+};
 
-	virtual void dump() const
+/**
+ * The memo table lookups for a rule during a warm-up parse.
+ */
+struct MemoSample
+{
+	//the rule, or null if it has not been sampled
+	const Rule *rule = nullptr;
+	//the number of times that the memo table was consulted
+	uint64_t lookups = 0;
+	//the number of memo table hits
+	uint64_t hits = 0;
+	//an estimate of the total work done by parsing the rule on a miss
+	uint64_t work = 0;
+};
+}
+
+/**
+ * The storage for a parse.  This is owned by a `ParseSession`, so that it can
+ * be reused by later parses.
+ */
+struct ParseSession::Storage
+{
+	//the memo table
+	MemoTable cache;
+	//the log of matches
+	MatchLog match_log;
+	//the innermost invocation of each rule, indexed by `Context::rule_index()`
+	ArenaVector<RuleState*> rule_states;
+	//the live backtrack points
+	ArenaVector<BacktrackPoint> backtrack_points;
+	//the backtrack points of the bytecode interpreter
+	ArenaVector<VMFrame> vm_frames;
+
+	/**
+	 * Constructs empty tables, which allocate from `a`, or from the heap if
+	 * `a` is null.
+	 */
+	explicit Storage(Arena *a = nullptr) :
+		cache(a),
+		match_log(a),
+		rule_states(ArenaAllocator<RuleState*>(a)),
+		backtrack_points(ArenaAllocator<BacktrackPoint>(a)),
+		vm_frames(ArenaAllocator<VMFrame>(a)) {}
+
+	/**
+	 * Empties the tables, keeping their memory.
+	 */
+	void reset()
 	{
-		left->dump();
-		fprintf(stderr, " | ");
-		right->dump();
+		cache.reset();
+		match_log.reset();
+		std::fill(rule_states.begin(), rule_states.end(), nullptr);
+		backtrack_points.clear();
+		vm_frames.clear();
 	}
 };
 
+//parsing context
+static_assert(std::is_same<MatchLog::Ref, decltype(ParserCursor::matches)>::value &&
+              (MatchLog::empty == 0),
+              "ParserCursor must start with an empty match log reference");
 
-//reference to rule
-class RuleReferenceExpr : public Expr
+class Context : public ParserCursor
 {
 public:
-	//constructor.
-	RuleReferenceExpr(const Rule &r) : referenced_rule(r) { }
+	//input
+	Input &input;
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	//const Rule that parses whitespace
+	const Rule &whitespace_rule;
+
+	//the numbering of the rules in the grammar
+	const GrammarLayout &layout;
+
+	//input begin
+	Input::iterator start;
+
+	//input end
+	Input::iterator finish;
+
+	//matches
+	MatchLog &match_log;
+
+	/**
+	 * Depth of parsing.  Used for trace expressions.
+	 */
+	int depth = 0;
+
+	const ParserDelegate &delegate;
+
+	/**
+	 * Counters for the work done by this parse.
+	 */
+	ParseStatistics statistics;
+
+	/**
+	 * The options for this parse.
+	 */
+	const ParseOptions options;
+
+	//constructor
+	Context(Input &i, const Rule &g, const Rule &ws, const ParserDelegate &d,
+	        const ParseOptions &o, ParseSession::Storage &s) :
+		ParserCursor(i),
+		input(i),
+		whitespace_rule(ws),
+		layout(g.layout(ws)),
+		start(i.begin()),
+		finish(i.end()),
+		match_log(s.match_log),
+		delegate(d),
+		options(o),
+		backtrack_points(s.backtrack_points),
+		rule_states(s.rule_states),
+		vm_frames(s.vm_frames),
+		cache(s.cache)
 	{
-		return con.parse_non_term(referenced_rule);
+		// Inputs either provide direct access everywhere or nowhere, so the
+		// kind of access is decided here.  The run itself may only cover
+		// part of the input, such as one fragment or chunk, and
+		// fetch_span() asks for a new one whenever the parser moves
+		// outside it.
+		Input::Index end;
+		byte_input = input.byteSpan(0, span_bytes, span_start, end);
+		character_input = !byte_input &&
+			input.characterSpan(0, span_characters, span_start, end);
+		if (byte_input || character_input)
+		{
+			span_length = end - span_start;
+		}
+		streaming = finish.index() == Input::npos;
+		if (rule_states.size() < layout.size())
+		{
+			rule_states.resize(layout.size());
+		}
 	}
 
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	//check if the end is reached
+	bool end() const
 	{
-		return con.parse_term(referenced_rule);
+		return position.it == finish;
 	}
 
-	virtual void dump() const
+	//get the current symbol
+	char32_t symbol()
 	{
-		fprintf(stderr, "{Reference to rule}");
+		assert(!end());
+		char32_t c = 0;
+		peek(c);
+		return c;
 	}
 
-private:
-	//reference
+	/**
+	 * Fetches the character at the current position into `c`, returning false
+	 * if the end of the input has been reached.  For inputs that provide
+	 * direct access to their storage, this is a single range check, which
+	 * also covers the end-of-input check.
+	 */
+	bool peek(char32_t &c)
+	{
+		Input::Index offset = position.it.index() - span_start;
+		if (offset < span_length)
+		{
+			c = span_bytes ? span_bytes[offset] : span_characters[offset];
+			return true;
+		}
+		if (end())
+		{
+			return false;
+		}
+		if (fetch_span(position.it.index(), 1))
+		{
+			offset = position.it.index() - span_start;
+			c = span_bytes ? span_bytes[offset] : span_characters[offset];
+			return true;
+		}
+		c = *position.it;
+		return true;
+	}
+
+	/**
+	 * Provides direct access to the `length` characters starting at the
+	 * current position, if the input supports it and they are contiguous.  On
+	 * success, exactly one of `bytes` and `characters` is set to point to the
+	 * first character, depending on how the input stores its data.
+	 */
+	bool direct(Input::Index length,
+	            const uint8_t *&bytes,
+	            const char32_t *&characters)
+	{
+		Input::Index n = position.it.index();
+		if (!fetch_span(n, length))
+		{
+			return false;
+		}
+		Input::Index offset = n - span_start;
+		bytes = span_bytes ? span_bytes + offset : nullptr;
+		characters = span_characters ? span_characters + offset : nullptr;
+		return true;
+	}
+
+	//set the longest possible error
+	void set_error_pos()
+	{
+		if (position.it > error_pos.it)
+		{
+			error_pos = position;
+		}
+	}
+
+	//next column
+	void next_col()
+	{
+		++position.it;
+		++position.col;
+	}
+
+	/**
+	 * Consume the specified number of characters in the input.
+	 */
+	void consume(size_t chars)
+	{
+		position.it += chars;
+		position.col += chars;
+	}
+
+	//next line
+	void next_line()
+	{
+		++position.line;
+		position.col = 1;
+	}
+
+	/**
+	 * Restores the state `st`.  This fails, returning false, if a cut has
+	 * been parsed since the state was saved, in which case the caller must
+	 * fail as well.
+	 */
+	bool restore(const ParsingState &st)
+	{
+		if (st.cuts != cuts)
+		{
+			return false;
+		}
+		position = st.position;
+		matches = st.matches;
+		return true;
+	}
+
+	/**
+	 * The index of the most recent cut.  The parser will never backtrack to
+	 * before this point.
+	 */
+	Input::Index cut_position = 0;
+
+	/**
+	 * The user data that is passed to the parse procedures.
+	 */
+	void *user_data = nullptr;
+
+	/**
+	 * Commits to the parse so far.  Saved states from before this point can
+	 * no longer be restored, so the matches so far are final: their parse
+	 * procedures are run and the match log is discarded.  The memo table
+	 * refers to the match log and to input before this point, so is cleared,
+	 * and for streaming inputs the input before this point can be released.
+	 */
+	void cut()
+	{
+		cuts++;
+		cut_position = position.it.index();
+		do_parse_procs(user_data);
+		match_log.reset();
+		matches = MatchLog::empty;
+		match_floor = Input::npos;
+		cache.reset();
+		if (streaming)
+		{
+			update_retention();
+		}
+	}
+
+	/**
+	 * Records a backtrack point at index `n`.  The parser may need to
+	 * access the input at any index after this point until the matching call
+	 * to `unpin()`.  Backtrack points nest, so only the outermost one needs
+	 * to be reported to the input.  If `match` is true then this is the start
+	 * of a rule that will record a match, which must be retained even if a
+	 * cut is parsed.
+	 */
+	void pin(Input::Index n, bool match=false)
+	{
+		backtrack_points.push_back({ n, match });
+		if (backtrack_points.size() == 1)
+		{
+			update_retention();
+		}
+	}
+
+	/**
+	 * Removes the most recent backtrack point.
+	 */
+	void unpin()
+	{
+		backtrack_points.pop_back();
+		if (backtrack_points.empty())
+		{
+			update_retention();
+		}
+	}
+
+	/**
+	 * Notes that a match starting at index `n` has been recorded.  The input
+	 * from this point must be retained until the parse procedures have run.
+	 */
+	void note_match(Input::Index n)
+	{
+		if (streaming)
+		{
+			match_floor = std::min(match_floor, n);
+		}
+	}
+
+	//parse non-term rule.
+	bool parse_non_term(const Rule &r);
+
+	//parse term rule.
+	bool parse_term(const Rule &r);
+
+	//parse whitespace terminal
+	bool parse_ws() { return parse_term(whitespace_rule); }
+
+	parse_proc get_parse_proc(const Rule &r) const
+	{
+		return delegate.get_parse_proc(r);
+	}
+
+	//execute all the parse procs
+	void do_parse_procs(void *d) const
+	{
+		match_log.for_each(matches, [&](const ParseMatch &m)
+			{
+				parse_proc p = get_parse_proc(*(m.matched_rule));
+				p(m.start, m.finish, d);
+			});
+	}
+
+	/**
+	 * Empty the cache.
+	 */
+	void clear_cache() { cache.reset(); }
+
+	/**
+	 * Chooses whether to memoize each rule that was sampled in this warm-up
+	 * parse.
+	 */
+	void choose_memo_policies()
+	{
+		// The number of lookups needed to judge a rule.
+		const uint64_t min_lookups = 64;
+		// The approximate cost of a lookup and insertion in the memo table,
+		// relative to the cost of examining a character.
+		const uint64_t lookup_cost = 16;
+		for (const MemoSample &s : memo_samples)
+		{
+			if (!s.rule || (s.lookups < min_lookups))
+			{
+				continue;
+			}
+			uint64_t parses = s.lookups - s.hits;
+			// Each hit saves the average work of a parse, and every lookup
+			// pays the cost of consulting the table, so memoizing pays off
+			// if: hits * (work / parses) >= lookups * lookup_cost
+			bool pays = s.hits * s.work >= s.lookups * lookup_cost * parses;
+			s.rule->memo_state.store(pays ? MEMO_ALWAYS : MEMO_NEVER,
+			                         std::memory_order_relaxed);
+		}
+	}
+
+private:
+	//generated code and expression templates call into the parser
+	friend class GeneratedContext;
+
+	//flag indicating whether the input can provide runs of bytes
+	bool byte_input;
+	//flag indicating whether the input can provide runs of 32-bit characters
+	bool character_input;
+
+	/**
+	 * The live backtrack points, for streaming inputs.  These nest, so the
+	 * indexes never decrease.
+	 */
+	ArenaVector<BacktrackPoint> &backtrack_points;
+	/**
+	 * The lowest start index of any recorded match, for streaming inputs.
+	 */
+	Input::Index match_floor = Input::npos;
+
+	/**
+	 * Informs the input of the oldest point that the parser may still need.
+	 */
+	void update_retention()
+	{
+		// Backtrack points from before the last cut can't be restored, so
+		// only the starts of matches count before it.
+		Input::Index floor = position.it.index();
+		for (const BacktrackPoint &p : backtrack_points)
+		{
+			if (p.match || (p.index >= cut_position))
+			{
+				floor = std::min(floor, p.index);
+				break;
+			}
+		}
+		input.release(std::min(floor, match_floor));
+	}
+
+	/**
+	 * Ensures that the current run covers the `length` characters starting at
+	 * index `n`, fetching a new run from the input if required.  Returns
+	 * false if this is not possible.
+	 */
+	bool fetch_span(Input::Index n, Input::Index length)
+	{
+		Input::Index offset = n - span_start;
+		if ((n >= span_start) && (offset <= span_length) &&
+		    (length <= span_length - offset))
+		{
+			return true;
+		}
+		Input::Index end;
+		if (byte_input)
+		{
+			if (!input.byteSpan(n, span_bytes, span_start, end))
+			{
+				return false;
+			}
+		}
+		else if (character_input)
+		{
+			if (!input.characterSpan(n, span_characters, span_start, end))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+		span_length = end - span_start;
+		offset = n - span_start;
+		return (n >= span_start) && (offset <= span_length) &&
+		       (length <= span_length - offset);
+	}
+
+	/**
+	 * The rules that are parsed but are not part of the layout of the
+	 * grammar, such as those reached only through expressions that don't
+	 * report the rules they refer to, with their indexes.
+	 */
+	std::unordered_map<const Rule*, uint32_t> extra_rules;
+	/**
+	 * Returns the index of rule `r` in the per-rule arrays of this parse.
+	 * Rules in the grammar's layout use their dense index and any others
+	 * are numbered after them.
+	 */
+	uint32_t rule_index(const Rule &r)
+	{
+		uint32_t index = layout.index(r);
+		if (index != GrammarLayout::npos)
+		{
+			return index;
+		}
+		auto inserted = extra_rules.insert(std::make_pair(std::addressof(r),
+			static_cast<uint32_t>(layout.size() + extra_rules.size())));
+		return inserted.first->second;
+	}
+	/**
+	 * The innermost invocation of each rule that is currently being parsed,
+	 * indexed by `rule_index()`.  The states live in the stack frames of
+	 * `parse_rule()` and are linked to the enclosing invocations of the same
+	 * rule, so entering a rule doesn't allocate.
+	 */
+	ArenaVector<RuleState*> &rule_states;
+	//parse non-term rule.
+	//parse term rule.
+	bool parse_rule(const Rule &r, bool (Context::*parse_func)(const Rule &));
+	bool _parse_non_term(const Rule &r);
+
+	bool _parse_term(const Rule &r);
+
+	/**
+	 * Parses the expression of rule `r`, as a terminal if `term` is true or
+	 * as a non-terminal otherwise.
+	 */
+	bool parse_body(const Rule &r, bool term)
+	{
+		const Expr *e = r.expr.get();
+		if (options.compile_rules)
+		{
+			const Program *p =
+				r.programs[term ? 1 : 0].load(std::memory_order_acquire);
+			if (!p)
+			{
+				p = &r.program(term);
+			}
+			if (GeneratedRule g = r.generated[term ? 1 : 0])
+			{
+				GeneratedContext c(*this, *this, p);
+				return g(c);
+			}
+			if (!p->direct)
+			{
+				return run(*p);
+			}
+			e = p->direct;
+		}
+		return term ? e->parse_term(*this) : e->parse_non_term(*this);
+	}
+
+	/**
+	 * Runs the bytecode for a rule, returning true if it matches.
+	 */
+	bool run(const Program &p);
+
+	/**
+	 * Saves a backtrack point for the bytecode interpreter.  Parsing continues
+	 * at instruction `alt` if the point is restored after a failure.
+	 */
+	void push_frame(Opcode kind, uint32_t alt)
+	{
+		vm_frames.push_back({ position, matches, cuts, alt, kind });
+		if (streaming)
+		{
+			pin(position.it.index());
+		}
+	}
+
+	/**
+	 * Discards the most recent backtrack point saved by the bytecode
+	 * interpreter and returns it.
+	 */
+	VMFrame pop_frame()
+	{
+		VMFrame f = vm_frames.back();
+		vm_frames.pop_back();
+		if (streaming)
+		{
+			unpin();
+		}
+		return f;
+	}
+
+	/**
+	 * Restores the state saved in a backtrack point, as `restore()`.
+	 */
+	bool restore(const VMFrame &f)
+	{
+		if (f.cuts != cuts)
+		{
+			return false;
+		}
+		position = f.position;
+		matches = f.matches;
+		return true;
+	}
+
+	/**
+	 * Returns the index of the first alternative in the dispatch table `d`,
+	 * from `from` onwards, that can start with the next character, or the
+	 * number of alternatives if none can.  The alternatives that are skipped
+	 * would have failed here, so this is recorded as an error position, as
+	 * it would have been by them.
+	 */
+	uint32_t select(const Dispatch &d, uint32_t from)
+	{
+		char32_t c = 0;
+		bool at_end = !peek(c);
+		uint32_t alt = d.select(from, at_end, c);
+		statistics.choice_dispatches++;
+		if (alt != from)
+		{
+			statistics.alternatives_skipped += alt - from;
+			set_error_pos();
+		}
+		return alt;
+	}
+
+	/**
+	 * Unwinds the backtrack points above `base` after a failure, until one
+	 * can continue.  Returns true and sets `alt` to the instruction to
+	 * continue at if one is found.  Points that can't be restored, because a
+	 * cut has been parsed since they were saved, fail as well.
+	 */
+	bool backtrack(size_t base, uint32_t &alt)
+	{
+		while (vm_frames.size() > base)
+		{
+			VMFrame f = pop_frame();
+			if (restore(f) && (f.kind != OP_AND))
+			{
+				alt = f.alt;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * The backtrack points saved by the bytecode interpreter.  Each call to
+	 * `run()` uses the points above the ones that were live when it started.
+	 */
+	ArenaVector<VMFrame> &vm_frames;
+
+	/*
+	 * The cache.  After each rule is parsed, we cache the result, whether it
+	 * matched or not, to avoid recomputing.
+	 */
+	MemoTable &cache;
+	/**
+	 * The number of rules that are currently being parsed.
+	 */
+	uint32_t rule_depth = 0;
+	/**
+	 * Value of `seed_depth` when the rule being parsed has not used a seed.
+	 */
+	static const uint32_t no_seed = UINT32_MAX;
+	/**
+	 * The depth of the outermost rule whose seed has been used by the rule
+	 * being parsed.  A result that depends on the seed of an enclosing rule
+	 * is provisional, and so is not cached.
+	 */
+	uint32_t seed_depth = no_seed;
+	/**
+	 * The lookups for each rule using `MEMO_AUTO`, indexed by
+	 * `rule_index()`.  This is only used in warm-up parses.
+	 */
+	std::vector<MemoSample> memo_samples;
+
+	/**
+	 * Records the result of consulting the memo table for rule `r` in a
+	 * warm-up parse.  On a miss, `rules` is the number of rules that were
+	 * parsed (including this one) and `characters` the number of characters
+	 * examined.
+	 */
+	void record_memo_sample(const Rule &r, bool hit, uint64_t rules,
+	                        uint64_t characters)
+	{
+		// The approximate cost of parsing a rule, relative to the cost of
+		// examining a character.
+		const uint64_t rule_cost = 16;
+		uint32_t index = rule_index(r);
+		if (index >= memo_samples.size())
+		{
+			memo_samples.resize(index + 1);
+		}
+		MemoSample &sample = memo_samples[index];
+		sample.rule = std::addressof(r);
+		sample.lookups++;
+		if (hit)
+		{
+			sample.hits++;
+		}
+		else
+		{
+			sample.work += rules * rule_cost + characters;
+		}
+	}
+};
+
+}
+
+namespace{
+
+/**
+ * Set expression: matches characters in a set.
+ */
+class SetExpr : public Expr
+{
+public:
+	//constructor from ansi string.
+	SetExpr(const char *s)
+	{
+		for(; *s; ++s)
+		{
+			_add(static_cast<char32_t>(*s));
+		}
+	}
+
+	//constructor from range.
+	SetExpr(char32_t min, char32_t max)
+	{
+		assert(min >= 0);
+		assert(min <= max);
+		mSetExpr.resize(static_cast<size_t>(max) + 1U);
+		for(; min <= max; ++min)
+		{
+			mSetExpr[static_cast<size_t>(min)] = true;
+		}
+	}
+
+	//constructor for an empty set, for adding to.
+	SetExpr() {}
+
+	//adds the character c
+	void add(char32_t c)
+	{
+		_add(c);
+	}
+
+	//adds the characters in another set
+	void add(const SetExpr &other)
+	{
+		if (other.mSetExpr.size() > mSetExpr.size())
+		{
+			mSetExpr.resize(other.mSetExpr.size());
+		}
+		for (size_t i = 0; i < other.mSetExpr.size(); i++)
+		{
+			if (other.mSetExpr[i])
+			{
+				mSetExpr[i] = true;
+			}
+		}
+	}
+
+	//returns true if the set contains the character c
+	bool contains(char32_t c) const
+	{
+		size_t ch = c;
+		return (ch < mSetExpr.size()) && mSetExpr[ch];
+	}
+
+	//one more than the largest character that may be in the set
+	char32_t limit() const
+	{
+		return static_cast<char32_t>(mSetExpr.size());
+	}
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return _parse(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		return _parse(con);
+	}
+
+	//compile
+	virtual void compile(ProgramBuilder &b, bool) const
+	{
+		b.emit(OP_SET, *this);
+	}
+
+	//characters that can start a match
+	virtual void first(FirstSet &set, bool) const
+	{
+		size_t size = mSetExpr.size();
+		for (size_t c = 0; (c < size) && (c < Dispatch::limit); c++)
+		{
+			if (mSetExpr[c])
+			{
+				set.add(static_cast<char32_t>(c));
+			}
+		}
+		if ((size > Dispatch::limit) &&
+		    (std::find(mSetExpr.begin() + Dispatch::limit, mSetExpr.end(),
+		               true) != mSetExpr.end()))
+		{
+			set.others = true;
+		}
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "[");
+		char c = 0;
+		for (bool v : mSetExpr)
+		{
+			if (v)
+				fprintf(stderr, "%c", c);
+			c++;
+		}
+		fprintf(stderr, "]");
+	}
+
+private:
+	//the interpreter matches sets without a virtual call
+	friend class pegmatite::Context;
+
+	//set is kept as an array of flags, for quick access
+	std::vector<bool> mSetExpr;
+
+	//add character
+	void _add(char32_t i)
+	{
+		if (i >= mSetExpr.size())
+		{
+			mSetExpr.resize(i + 1);
+		}
+		mSetExpr[i] = true;
+	}
+
+	//internal parse
+	bool _parse(Context &con) const
+	{
+		char32_t c;
+		if (con.peek(c))
+		{
+			size_t ch = c;
+			if (ch < mSetExpr.size() && mSetExpr[ch])
+			{
+				con.next_col();
+				return true;
+			}
+		}
+		con.set_error_pos();
+		return false;
+	}
+};
+
+/**
+ * Adaptor that modifies the type of the iterator.  This lets us use iterators
+ * with things that expect char or whcar_t iterators (as long as casts work
+ * appropriately).
+ */
+template<typename Src, typename Out, typename In>
+class IteratorAdaptor : public std::iterator<std::bidirectional_iterator_tag, Out>
+{
+		Src s;
+		public:
+		inline IteratorAdaptor(Src src) : s(src) {}
+		inline IteratorAdaptor() {}
+		inline Out operator*() const { return static_cast<Out>(*s); }
+		inline IteratorAdaptor &operator++()
+		{
+			++s;
+			return *this;
+		}
+		inline IteratorAdaptor<Src, Out,In> operator++(int /*dummy*/)
+		{
+			auto copy = *this;
+			s++;
+			return copy;
+		}
+		inline IteratorAdaptor<Src, Out,In> &operator--()
+		{
+			--s;
+			return *this;
+		}
+		inline bool operator==(const IteratorAdaptor<Src, Out,In> &other) const
+		{
+			return s == other.s;
+		}
+		inline bool operator!=(const IteratorAdaptor<Src, Out,In> &other) const
+		{
+			return s != other.s;
+		}
+		inline bool operator>(const IteratorAdaptor<Src, Out,In> &other) const
+		{
+			return s > other.s;
+		}
+		inline bool operator<(const IteratorAdaptor<Src, Out,In> &other) const
+		{
+			return s < other.s;
+		}
+};
+
+/**
+ * Preform a regular expression match, starting at `begin` and trying to match
+ * up to `end`.  Returns true if the regular expression matches the input,
+ * false otherwise.  If there is a match, then `length` will be set to the
+ * length of the match.
+ */
+template <typename T>
+bool regexMatch(Input::iterator begin,
+                Input::iterator end,
+                const std::basic_regex<T> &r,
+                size_t &length)
+{
+	typedef IteratorAdaptor<Input::iterator, T, char32_t> Iterator;
+	std::match_results<Iterator> match;
+	Iterator b(begin), e(end);
+	if (std::regex_search(b, e, match, r, std::regex_constants::match_continuous))
+	{
+		length = static_cast<size_t>(match.length());
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Perform a regular expression match directly on the bytes of the input,
+ * with `begin` and `end` delimiting the rest of the input.
+ */
+bool regexMatch(const uint8_t *begin,
+                const uint8_t *end,
+                const std::regex &r,
+                size_t &length)
+{
+	std::cmatch match;
+	const char *b = reinterpret_cast<const char*>(begin);
+	const char *e = reinterpret_cast<const char*>(end);
+	if (std::regex_search(b, e, match, r, std::regex_constants::match_continuous))
+	{
+		length = static_cast<size_t>(match.length());
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Wide regular expressions can not be matched directly against the bytes of
+ * the input, so always fall back to the iterator version.
+ */
+bool regexMatch(const uint8_t *, const uint8_t *, const std::wregex &, size_t &)
+{
+	return false;
+}
+
+/**
+ * Matches characters that correspond to a given regular expression.
+ */
+template<typename CharTy>
+class RegexExpr : public Expr
+{
+	std::basic_regex<CharTy> r;
+	bool parse(Context &con) const
+	{
+		size_t length;
+		// If the rest of the input is available as bytes, then match directly
+		// against it, rather than via the iterator adaptors.
+		Input::Index remaining = con.finish - con.position.it;
+		const uint8_t *bytes = nullptr;
+		const char32_t *characters;
+		if (std::is_same<CharTy, char>::value)
+		{
+			con.direct(remaining, bytes, characters);
+		}
+		if (bytes ? regexMatch(bytes, bytes + remaining, r, length) :
+		            regexMatch(con.position.it, con.finish, r, length))
+		{
+			con.consume(length);
+			return true;
+		}
+		con.set_error_pos();
+		return false;
+	}
+public:
+	RegexExpr(const CharTy *s) : r(s, std::regex_constants::optimize) {}
+	RegexExpr(const CharTy *s, size_t count) : r(s, count, std::regex_constants::optimize) {}
+
+	virtual bool parse_non_term(Context &con) const
+	{
+		return parse(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		return parse(con);
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "<regex>");
+	}
+};
+
+
+//base class for unary expressions
+class UnaryExpr : public Expr
+{
+public:
+	UnaryExpr(const ExprPtr e) : expr(e) { }
+
+	virtual void rules(std::vector<const Rule*> &rules) const
+	{
+		expr->rules(rules);
+	}
+protected:
+	const ExprPtr expr;
+};
+
+
+//terminal
+class TerminalExpr : public UnaryExpr
+{
+public:
+	//constructor.
+	TerminalExpr(const ExprPtr e) :
+		UnaryExpr(e)
+	{
+	}
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return expr->parse_term(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		return expr->parse_term(con);
+	}
+
+	virtual void compile(ProgramBuilder &b, bool) const
+	{
+		b.expr(expr, true);
+	}
+
+	virtual void first(FirstSet &set, bool) const
+	{
+		expr->first(set, true);
+	}
+
+	virtual void dump() const
+	{
+		expr->dump();
+	}
+
+};
+
+
+//loop 0
+class Loop0Expr : public UnaryExpr
+{
+public:
+	//constructor.
+	Loop0Expr(const ExprPtr e) :
+		UnaryExpr(e)
+	{
+	}
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		//if parsing of the first fails, restore the context and stop
+		con.parse_ws();
+		ParsingState st(con);
+		if (!expr->parse_non_term(con))
+		{
+			return con.restore(st);
+		}
+
+		//parse the rest
+		for(;;)
+		{
+			con.parse_ws();
+			ParsingState s(con);
+			if (!expr->parse_non_term(con))
+			{
+				return con.restore(s);
+			}
+		}
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		//if parsing of the first fails, restore the context and stop
+		ParsingState st(con);
+		if (!expr->parse_term(con))
+		{
+			return con.restore(st);
+		}
+
+		//parse the rest until no more parsing is possible
+		for(;;)
+		{
+			ParsingState s(con);
+			if (!expr->parse_term(con))
+			{
+				return con.restore(s);
+			}
+		}
+	}
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.repeat(expr, term);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		// As a non-terminal, this starts by parsing whitespace.
+		if (!term)
+		{
+			set.unknown();
+			return;
+		}
+		expr->first(set, term);
+		set.nullable = true;
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "*( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//loop 1
+class Loop1Expr : public UnaryExpr
+{
+public:
+	Loop1Expr(const ExprPtr e) : UnaryExpr(e) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		//parse the first; if the first fails, stop
+		con.parse_ws();
+		if (!expr->parse_non_term(con)) return false;
+
+		//parse the rest until no more parsing is possible
+		for(;;)
+		{
+			con.parse_ws();
+			ParsingState st(con);
+			if (!expr->parse_non_term(con))
+			{
+				return con.restore(st);
+			}
+		}
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		//parse the first; if the first fails, stop
+		if (!expr->parse_term(con)) return false;
+
+		//parse the rest until no more parsing is possible
+		for(;;)
+		{
+			ParsingState st(con);
+			if (!expr->parse_term(con))
+			{
+				return con.restore(st);
+			}
+		}
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		if (!term)
+		{
+			b.emit(OP_WS);
+		}
+		b.expr(expr, term);
+		b.repeat(expr, term);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		// As a non-terminal, this starts by parsing whitespace.
+		if (!term)
+		{
+			set.unknown();
+			return;
+		}
+		expr->first(set, term);
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "+( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//optional
+class OptionalExpr : public UnaryExpr
+{
+public:
+	OptionalExpr(const ExprPtr e) : UnaryExpr(e) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		ParsingState st(con);
+		if (!expr->parse_non_term(con)) return con.restore(st);
+		return true;
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		ParsingState st(con);
+		if (!expr->parse_term(con)) return con.restore(st);
+		return true;
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		uint32_t choice = b.emit(OP_CHOICE);
+		b.expr(expr, term);
+		uint32_t commit = b.emit(OP_COMMIT);
+		b.patch(choice);
+		b.patch(commit);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		expr->first(set, term);
+		set.nullable = true;
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "-( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//and
+// Try to parse expr, succeed iff the parse succeeds, but do not
+// consume any input.
+class AndExpr : public UnaryExpr
+{
+public:
+	AndExpr(const ExprPtr e) : UnaryExpr(e) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		ParsingState st(con);
+		bool ok = expr->parse_non_term(con);
+		return con.restore(st) && ok;
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		ParsingState st(con);
+		bool ok = expr->parse_term(con);
+		return con.restore(st) && ok;
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.emit(OP_AND);
+		b.expr(expr, term);
+		b.emit(OP_AND_END);
+	}
+
+	// This fails where the expression does, so the same characters can
+	// start it, although it doesn't consume them.
+	virtual void first(FirstSet &set, bool term) const
+	{
+		expr->first(set, term);
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "&( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//not
+class NotExpr : public UnaryExpr
+{
+public:
+	NotExpr(const ExprPtr e) : UnaryExpr(e) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		ParsingState st(con);
+		bool ok = !expr->parse_non_term(con);
+		return con.restore(st) && ok;
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		ParsingState st(con);
+		bool ok = !expr->parse_term(con);
+		return con.restore(st) && ok;
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		uint32_t predicate = b.emit(OP_NOT);
+		b.expr(expr, term);
+		b.emit(OP_NOT_END);
+		b.patch(predicate);
+	}
+
+	// This succeeds without looking further when the next character can't
+	// start the expression.  Otherwise, the expression may look at more of
+	// the input, so its characters are included.
+	virtual void first(FirstSet &set, bool term) const
+	{
+		FirstSet e = set.of(*expr.get(), term);
+		if (e.nullable)
+		{
+			set.unknown();
+			return;
+		}
+		set.add(e);
+		set.nullable = true;
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "!( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//newline
+class NewlineExpr : public UnaryExpr
+{
+public:
+	NewlineExpr(const ExprPtr e) : UnaryExpr(e) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		if (!expr->parse_non_term(con)) return false;
+		con.next_line();
+		return true;
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		if (!expr->parse_term(con)) return false;
+		con.next_line();
+		return true;
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.expr(expr, term);
+		b.emit(OP_NEWLINE);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		expr->first(set, term);
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "nl( ");
+		expr->dump();
+		fprintf(stderr, " )");
+	}
+};
+
+
+//base class for binary expressions
+class BinaryExpr : public Expr
+{
+public:
+	BinaryExpr(const ExprPtr &l, const ExprPtr &r) :
+		left(l), right(r) { }
+
+	virtual void rules(std::vector<const Rule*> &rules) const
+	{
+		left->rules(rules);
+		right->rules(rules);
+	}
+protected:
+	const ExprPtr left, right;
+};
+
+
+//sequence
+class SequenceExpr : public BinaryExpr
+{
+public:
+	SequenceExpr(const ExprPtr left, const ExprPtr right) : BinaryExpr(left, right) {}
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		if (!left->parse_non_term(con)) return false;
+		con.parse_ws();
+		return right->parse_non_term(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		if (!left->parse_term(con)) return false;
+		return right->parse_term(con);
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.expr(left, term);
+		if (!term)
+		{
+			b.emit(OP_WS);
+		}
+		b.expr(right, term);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		FirstSet l = set.of(*left.get(), term);
+		set.add(l);
+		if (!l.nullable)
+		{
+			return;
+		}
+		// Whitespace may come next, and the whitespace rule is only known
+		// when parsing.
+		if (!term)
+		{
+			set.unknown();
+			return;
+		}
+		FirstSet r = set.of(*right.get(), term);
+		set.add(r);
+		set.nullable |= r.nullable;
+	}
+
+	virtual void dump() const
+	{
+		left->dump();
+		fprintf(stderr, " >> ");
+		right->dump();
+	}
+};
+
+
+//choice
+class ChoiceExpr : public BinaryExpr
+{
+public:
+	ChoiceExpr(const ExprPtr &left, const ExprPtr &right) :
+		BinaryExpr(left, right) {}
+
+	virtual bool parse_non_term(Context &con) const
+	{
+		ParsingState st(con);
+		if (left->parse_non_term(con)) return true;
+		if (!con.restore(st)) return false;
+		return right->parse_non_term(con);
+	}
+
+	virtual bool parse_term(Context &con) const
+	{
+		ParsingState st(con);
+		if (left->parse_term(con)) return true;
+		if (!con.restore(st)) return false;
+		return right->parse_term(con);
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.choice(*this, term);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		set.alternative(*this, *left.get(), term);
+		set.alternative(*this, *right.get(), term);
+	}
+
+	virtual void dump() const
+	{
+		left->dump();
+		fprintf(stderr, " | ");
+		right->dump();
+	}
+};
+
+
+//reference to rule
+class RuleReferenceExpr : public Expr
+{
+public:
+	//constructor.
+	RuleReferenceExpr(const Rule &r) : referenced_rule(r) { }
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return con.parse_non_term(referenced_rule);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		return con.parse_term(referenced_rule);
+	}
+
+	virtual void compile(ProgramBuilder &b, bool term) const
+	{
+		b.emit(term ? OP_RULE_TERM : OP_RULE_NON_TERM, referenced_rule);
+	}
+
+	virtual void first(FirstSet &set, bool term) const
+	{
+		set.rule(referenced_rule, term);
+	}
+
+	virtual void rules(std::vector<const Rule*> &rules) const
+	{
+		rules.push_back(std::addressof(referenced_rule));
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "{Reference to rule}");
+	}
+
+private:
+	//reference
 	const Rule &referenced_rule;
 };
 
 
-//eof
-class EndOfFileExpr : public Expr
+//eof
+class EndOfFileExpr : public Expr
+{
+public:
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return parse_term(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		return con.end();
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "$eof");
+	}
+};
+
+
+/**
+ * Cut expression.  Always succeeds without consuming any input, and commits
+ * the parser to the parse so far (see `Context::cut()`).
+ */
+class CutExpr : public Expr
+{
+public:
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return parse_term(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		con.cut();
+		return true;
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "$commit");
+	}
+};
+
+
+//AnyExpr
+class AnyExpr : public Expr
+{
+public:
+	//parse with whitespace
+	virtual bool parse_non_term(Context &con) const
+	{
+		return parse_term(con);
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &con) const
+	{
+		if (!con.end())
+		{
+			con.next_col();
+			return true;
+		}
+		con.set_error_pos();
+		return false;
+	}
+
+	virtual void compile(ProgramBuilder &b, bool) const
+	{
+		b.emit(OP_ANY);
+	}
+
+	virtual void first(FirstSet &set, bool) const
+	{
+		set.add_all();
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "$AnyExpr");
+	}
+};
+/**
+ * Trace expressions have no effect on parsing.  They wrap another expression
+ * and log a message when parsing for it begins and ends, along with whether it
+ * succeeds.
+ */
+class TraceExpr : public Expr
+{
+	/**
+	 * The message to log for this expression.
+	 */
+	const char *message;
+	/**
+	 * The real expression that will handle the parsing.
+	 */
+	const ExprPtr expr;
+	void log(int depth, const char *event, const char *result, Context &con) const
+	{
+		fprintf(stderr, "[%d] ", depth);
+		for (int i=0 ; i<depth ; i++)
+		{
+			fprintf(stderr, " ");
+		}
+		fprintf(stderr, "%s %s (line %d, column %d)\n",
+		                event,
+		                result,
+		                con.position.line,
+		                con.position.col);
+	}
+public:
+	TraceExpr(const char *m, const ExprPtr e) : message(m), expr(e) {}
+
+	virtual bool parse_non_term(Context &con) const
+	{
+		log(con.depth++, "Trying", message, con);
+		bool result = expr->parse_non_term(con);
+		log(--con.depth, message, result ? "succeeded" : "failed", con);
+		return result;
+	}
+	virtual bool parse_term(Context &con) const
+	{
+		log(con.depth++, "Trying", message, con);
+		bool result = expr->parse_term(con);
+		log(--con.depth, message, result ? "succeeded" : "failed", con);
+		return result;
+	}
+
+	virtual void rules(std::vector<const Rule*> &rules) const
+	{
+		expr->rules(rules);
+	}
+
+	virtual void dump() const
+	{
+		expr->dump();
+	}
+};
+class DebugExpr : public Expr
+{
+	std::function<void()> fn;
+public:
+	DebugExpr(std::function<void()> f) : fn(f) {}
+
+	//parse with whitespace
+	virtual bool parse_non_term(Context &) const
+	{
+		fn();
+		return true;
+	}
+
+	//parse terminal
+	virtual bool parse_term(Context &) const
+	{
+		fn();
+		return true;
+	}
+
+	virtual void dump() const
+	{
+		fprintf(stderr, "<DEBUG: ");
+		fn();
+		fprintf(stderr, ">");
+	}
+};
+
+//constructor
+ParsingState::ParsingState(Context &con) :
+	position(con.position),
+	matches(con.matches),
+	cuts(con.cuts),
+	pinned(con.streaming ? &con : nullptr)
+{
+	if (pinned)
+	{
+		con.pin(position.it.index());
+	}
+}
+
+ParsingState::~ParsingState()
+{
+	if (pinned)
+	{
+		pinned->unpin();
+	}
+}
+
+/**
+ * Returns the length of the common prefix of the `length` characters starting
+ * at `input` and the characters in `characters`.
+ */
+template<typename T>
+static inline size_t matchPrefix(const T *input,
+                                 const std::vector<char32_t> &characters,
+                                 size_t length)
+{
+	size_t i = 0;
+	while ((i < length) && (input[i] == characters[i]))
+	{
+		i++;
+	}
+	return i;
+}
+
+static inline bool parseString(Context &con,
+                               const std::vector<char32_t> &characters)
+{
+	// If the input provides direct access to its storage, then compare
+	// against it directly.  This only needs to check the bounds once, for the
+	// whole string.
+	size_t length = characters.size();
+	const uint8_t *bytes;
+	const char32_t *direct_characters;
+	if (con.direct(length, bytes, direct_characters))
+	{
+		size_t i = bytes ? matchPrefix(bytes, characters, length) :
+		                   matchPrefix(direct_characters, characters, length);
+		con.consume(i);
+		if (i == length)
+		{
+			return true;
+		}
+		con.set_error_pos();
+		return false;
+	}
+	for (char32_t c : characters)
+	{
+		if (con.end() || con.symbol() != c)
+		{
+			con.set_error_pos();
+			return false;
+		}
+		con.next_col();
+	}
+	return true;
+}
+bool StringExpr::parse_non_term(Context &con) const
+{
+	return parseString(con, characters);
+}
+bool StringExpr::parse_term(Context &con) const
+{
+	return parseString(con, characters);
+}
+void StringExpr::compile(ProgramBuilder &b, bool term) const
+{
+	b.string(*this, term);
+}
+void StringExpr::first(FirstSet &set, bool) const
+{
+	if (characters.empty())
+	{
+		set.nullable = true;
+		return;
+	}
+	set.add(characters[0]);
+}
+void StringExpr::dump() const
+{
+	fprintf(stderr, "\"");
+	for (char32_t c : characters)
+	{
+		fprintf(stderr, "%c", static_cast<char>(c));
+	}
+	fprintf(stderr, "\"");
+}
+
+
+
+}
+
+namespace pegmatite {
+
+FirstSet FirstSet::of(const Expr &e, bool term) const
+{
+	FirstSet set(*active);
+	e.first(set, term);
+	return set;
+}
+
+void FirstSet::alternative(const Expr &choice, const Expr &e, bool term)
+{
+	FirstSet set(*active);
+	bool flatten = alternatives && (split == &choice);
+	size_t count = 0;
+	if (flatten)
+	{
+		set.split = &e;
+		set.alternatives = alternatives;
+		count = alternatives->size();
+	}
+	e.first(set, term);
+	// A nested choice adds its own alternatives.
+	if (flatten && (alternatives->size() == count))
+	{
+		set.split = nullptr;
+		set.alternatives = nullptr;
+		alternatives->push_back({ &e, set });
+	}
+	add(set);
+	nullable |= set.nullable;
+}
+
+void FirstSet::rule(const Rule &r, bool term)
+{
+	std::atomic<const FirstSet*> &slot = r.first_sets[term ? 1 : 0];
+	const FirstSet *known = slot.load(std::memory_order_acquire);
+	if (!known)
+	{
+		// A rule that is reached again before anything has been consumed is
+		// left recursive, so the parser grows its match from a seed rather
+		// than following the expression.
+		const Rule *address = std::addressof(r);
+		if (std::find(active->begin(), active->end(), address) != active->end())
+		{
+			unknown();
+			return;
+		}
+		active->push_back(address);
+		FirstSet *computed = new FirstSet(of(*r.expr.get(), term));
+		active->pop_back();
+		computed->active = nullptr;
+		const FirstSet *expected = nullptr;
+		if (slot.compare_exchange_strong(expected, computed,
+		                                 std::memory_order_acq_rel))
+		{
+			known = computed;
+		}
+		else
+		{
+			// Another thread got there first.
+			delete computed;
+			known = expected;
+		}
+	}
+	add(*known);
+	nullable |= known->nullable;
+}
+
+void ProgramBuilder::choice(const Expr &e, bool term)
+{
+	std::vector<const Rule*> active;
+	std::vector<FirstSet::Alternative> alternatives;
+	FirstSet all(active);
+	all.split = &e;
+	all.alternatives = &alternatives;
+	e.first(all, term);
+	// The table is only worth consulting if the next character can rule out
+	// one of the alternatives.
+	bool predict = false;
+	for (const FirstSet::Alternative &a : alternatives)
+	{
+		predict |= a.first.excludes();
+	}
+	std::vector<Instruction> &code = program.code;
+	uint32_t start = here();
+	uint32_t count = static_cast<uint32_t>(alternatives.size());
+	std::vector<uint32_t> dispatches;
+	std::vector<uint32_t> entries;
+	std::vector<uint32_t> commits;
+	std::vector<Instruction> bodies;
+	if (predict)
+	{
+		dispatches.push_back(emit(OP_DISPATCH, 0));
+	}
+	for (uint32_t i = 0; i < count; i++)
+	{
+		bool last = (i + 1 == count);
+		entries.push_back(label());
+		uint32_t choice = last ? 0 : emit(OP_CHOICE);
+		uint32_t body = here();
+		alternatives[i].expr->compile(*this, term);
+		if ((here() == body + 1) &&
+		    ((code[body].op == OP_CHAR) || (code[body].op == OP_SET)))
+		{
+			bodies.push_back(code[body]);
+		}
+		if (!last)
+		{
+			commits.push_back(emit(OP_COMMIT));
+			patch(choice);
+			if (predict)
+			{
+				dispatches.push_back(emit(OP_DISPATCH, i + 1));
+			}
+		}
+	}
+	for (uint32_t commit : commits)
+	{
+		patch(commit);
+	}
+	if (bodies.size() == count)
+	{
+		SetExpr *set = new SetExpr();
+		own(set);
+		for (const Instruction &i : bodies)
+		{
+			if (i.op == OP_CHAR)
+			{
+				set->add(static_cast<char32_t>(i.arg));
+			}
+			else
+			{
+				set->add(*static_cast<const SetExpr*>(i.expr));
+			}
+		}
+		code.resize(start);
+		emit(OP_SET, *set);
+		// Nothing jumps to the end of the choice any more.
+		target = UINT32_MAX;
+		return;
+	}
+	if (!predict)
+	{
+		return;
+	}
+	std::unique_ptr<Dispatch> table(new Dispatch());
+	table->entries = entries;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const FirstSet &first = alternatives[i].first;
+		bool always = first.nullable || (i >= Dispatch::last_bit);
+		uint64_t bit = 1ULL << Dispatch::last_bit;
+		if (i < Dispatch::last_bit)
+		{
+			bit = 1ULL << i;
+		}
+		for (char32_t c = 0; c < Dispatch::limit; c++)
+		{
+			if (always || first.characters.test(c))
+			{
+				table->characters[c] |= bit;
+			}
+		}
+		if (always || first.others)
+		{
+			table->others |= bit;
+		}
+		if (always)
+		{
+			table->end |= bit;
+		}
+	}
+	for (uint32_t d : dispatches)
+	{
+		code[d].dispatch = table.get();
+	}
+	program.tables.push_back(std::move(table));
+}
+
+//parse non-term rule.
+bool Context::parse_non_term(const Rule &r)
+{
+	return parse_rule(r, &Context::_parse_non_term);
+}
+
+bool Context::parse_rule(const Rule &r, bool (Context::*parse_func)(const Rule &))
+{
+	// For each rule, we maintain a stack of the invocations that are
+	// currently being parsed.  Rules outside the grammar's layout are
+	// numbered after it, so won't have a slot yet.
+	uint32_t index = rule_index(r);
+	if (index >= rule_states.size())
+	{
+		rule_states.resize(index + 1);
+	}
+	RuleState *active = rule_states[index];
+
+	// Compute the new position in the stream.  We're only tracking offsets to
+	// detect left recursion, not storing iterators.
+	size_t new_pos = position.it - start;
+
+	// Check if we have left recursion.  We are in a left-recursive state if
+	// the innermost invocation of this rule is at the same point in the input.
+	// In this case, use the seed instead of parsing the rule again.
+	if (active && (active->position == new_pos))
+	{
+		RuleState &head = *active;
+		head.left_recursive = true;
+		seed_depth = std::min(seed_depth, head.depth);
+		if (!head.seed_ok)
+		{
+			return false;
+		}
+		if (head.seed_from != head.seed_to)
+		{
+			matches = match_log.splice(matches, head.seed_from, head.seed_to);
+		}
+		position = head.seed_end;
+		return true;
+	}
+
+	// Return value (success or failure of parse)
+	bool ok;
+
+	// Look up the current rule and parser position in the cache to see if
+	// we've been here before.  Rules parse differently as terminals and
+	// non-terminals, so these are cached separately.
+	Input::Index start_index = position.it.index();
+	uint32_t key = (r.id << 1) | (parse_func == &Context::_parse_term ? 1 : 0);
+	int memo = r.memo_state.load(std::memory_order_relaxed);
+	// A warm-up parse memoizes every rule using MEMO_AUTO, whatever was
+	// chosen before, so that it can see how often the results are reused.
+	bool sampling = options.memo_warm_up && (r.memo_policy == MEMO_AUTO);
+	if (sampling)
+	{
+		memo = MEMO_AUTO;
+	}
+	MemoTable::Entry *cache_entry = nullptr;
+	if (memo != MEMO_NEVER)
+	{
+		cache_entry = cache.find(key, start_index);
+		if (!cache_entry && cache.was_evicted(key, start_index))
+		{
+			statistics.memo_reparses++;
+		}
+	}
+	if (cache_entry)
+	{
+		if (sampling)
+		{
+			record_memo_sample(r, true, 0, 0);
+		}
+		if (cache_entry->error_pos.it > error_pos.it)
+		{
+			error_pos = cache_entry->error_pos;
+		}
+		if (!cache_entry->ok)
+		{
+			statistics.memo_failure_hits++;
+			return false;
+		}
+		statistics.memo_hits++;
+		// If we have a cache entry then grab the list of matched rules and the
+		// end parsing position from the cache and don't bother trying to apply
+		// the rules again.
+		if (cache_entry->matches_from != cache_entry->matches_to)
+		{
+			matches = match_log.splice(matches, cache_entry->matches_from,
+			                           cache_entry->matches_to);
+			note_match(start_index);
+		}
+		position = cache_entry->end;
+		return true;
+	}
+
+	ParserPosition start_pos = position;
+	MatchLog::Ref start_matches = matches;
+	uint64_t start_cuts = cuts;
+	uint64_t start_parses = statistics.rule_parses++;
+	// Record the furthest error found while parsing this rule separately, so
+	// that it can be cached with the result.
+	ParserPosition outer_error_pos = error_pos;
+	error_pos = position;
+	uint32_t depth = rule_depth++;
+	uint32_t outer_seed_depth = seed_depth;
+	seed_depth = no_seed;
+	// Growing a seed returns to the start of the rule.
+	if (streaming)
+	{
+		pin(start_index);
+	}
+
+	RuleState state(new_pos, depth, active);
+	rule_states[index] = &state;
+	ok = (this->*parse_func)(r);
+	// If the rule was reached again at this position, then the result so far
+	// is a seed.  Make it visible to the recursive invocations and parse the
+	// rule again, for as long as that consumes more input.  The parser can't
+	// return to the start of the rule after a cut, so stop growing there.
+	while (ok && state.left_recursive && (cuts == start_cuts))
+	{
+		state.seed_ok = true;
+		state.seed_end = position;
+		state.seed_from = start_matches;
+		state.seed_to = matches;
+		position = start_pos;
+		matches = start_matches;
+		statistics.rule_parses++;
+		bool grown = (this->*parse_func)(r);
+		if (cuts != start_cuts)
+		{
+			ok = grown;
+			break;
+		}
+		if (!grown || (position.it.index() <= state.seed_end.it.index()))
+		{
+			position = state.seed_end;
+			matches = state.seed_to;
+			break;
+		}
+	}
+	rule_states[index] = active;
+
+	if (streaming)
+	{
+		unpin();
+	}
+	rule_depth--;
+	// The result is provisional if it used the seed of an enclosing rule.
+	// Using this rule's own seed is fine, as the seed has been grown.
+	bool provisional = seed_depth < depth;
+	seed_depth = provisional ? std::min(outer_seed_depth, seed_depth) :
+	                           outer_seed_depth;
+
+	ParserPosition rule_error_pos = error_pos;
+	if (outer_error_pos.it > error_pos.it)
+	{
+		error_pos = outer_error_pos;
+	}
+
+	if (sampling)
+	{
+		// Estimate the work done as the number of rules parsed and the number
+		// of characters examined, which is at least as far as the furthest
+		// error.
+		Input::Index examined =
+			std::max(position.it.index(), rule_error_pos.it.index()) - start_index;
+		record_memo_sample(r, false, statistics.rule_parses - start_parses,
+		                   examined);
+	}
+
+	// Cache the result, unless it depends on the seed of some enclosing
+	// left-recursive rule.  In that case, parsing the same rule again once the
+	// seed has grown may give a different result.  Rules that contain a cut
+	// are not cached either, as the cut has discarded the matches that they
+	// refer to and the parser can't return to their start.
+	if ((memo != MEMO_NEVER) && !provisional && (cuts == start_cuts) &&
+	    (ok || options.memoize_failures))
+	{
+		// If the table is full, then evict the entries that are furthest
+		// behind the current position.  Evicting down to half of the budget
+		// means that the cost of rebuilding the table is amortised over many
+		// insertions.
+		if ((options.memo_budget != 0) && (cache.size() >= options.memo_budget))
+		{
+			Input::Index now = position.it.index();
+			Input::Index limit = (now > options.memo_lookbehind) ?
+				now - options.memo_lookbehind : 0;
+			statistics.memo_evictions +=
+				cache.evict(limit, options.memo_budget / 2);
+		}
+		auto &new_cache = cache.insert(key, start_index);
+		statistics.memo_insertions++;
+		new_cache.ok = ok;
+		new_cache.error_pos = rule_error_pos;
+		if (!ok)
+		{
+			new_cache.matches_from = new_cache.matches_to = MatchLog::empty;
+			return false;
+		}
+		new_cache.end = position;
+		// Record the rules that were matched by referring to them in the log
+		new_cache.matches_from = start_matches;
+		new_cache.matches_to = matches;
+	}
+
+	return ok;
+}
+
+
+
+//parse term rule.
+bool Context::parse_term(const Rule &r) 
+{
+	return parse_rule(r, &Context::_parse_term);
+}
+const bool debug_parsing = false;
+
+
+//parse non-term rule internal.
+bool Context::_parse_non_term(const Rule &r)
+{
+	bool ok;
+	if (get_parse_proc(r))
+	{
+		ParserPosition b = position;
+		// The start of the rule must be retained until the match is recorded
+		if (streaming)
+		{
+			pin(b.it.index(), true);
+		}
+		ok = parse_body(r, false);
+		if (streaming)
+		{
+			if (ok)
+			{
+				note_match(b.it.index());
+			}
+			unpin();
+		}
+		if (debug_parsing)
+		{
+			r.expr->dump();
+			fprintf(stderr, "\n");
+		}
+		if (ok)
+		{
+			matches = match_log.append(matches,
+			                           ParseMatch(std::addressof(r), b, position));
+		}
+	}
+	else
+	{
+		ok = parse_body(r, false);
+	}
+	return ok;
+}
+
+
+//parse term rule internal.
+bool Context::_parse_term(const Rule &r)
+{
+	bool ok;
+	if (get_parse_proc(r))
+	{
+		ParserPosition b = position;
+		// The start of the rule must be retained until the match is recorded
+		if (streaming)
+		{
+			pin(b.it.index(), true);
+		}
+		ok = parse_body(r, true);
+		if (streaming)
+		{
+			if (ok)
+			{
+				note_match(b.it.index());
+			}
+			unpin();
+		}
+		if (ok)
+		{
+			matches = match_log.append(matches,
+			                           ParseMatch(std::addressof(r), b, position));
+		}
+	}
+	else
+	{
+		ok = parse_body(r, true);
+	}
+	return ok;
+}
+
+
+//get the next position
+static ParserPosition _next_pos(const ParserPosition &p)
+{
+	ParserPosition r = p;
+	++r.it;
+	++r.col;
+	return r;
+}
+
+
+//get syntax error
+static Error _syntax_Error(Context &con)
+{
+	std::string str = "syntax error: ";
+	str += static_cast<char>(*con.error_pos.it);
+	return Error(con.error_pos, _next_pos(con.error_pos), ERROR_SYNTAX_ERROR);
+}
+
+
+//get eof error
+static Error _eof_Error(Context &con)
+{
+	return Error(con.error_pos, con.error_pos, ERROR_INVALID_EOF);
+}
+
+char32_t Input::slowCharacterLookup(Index n)
+{
+	// The number of misses between reconsidering the size of the window.
+	const Index adapt_interval = 32;
+	if (n >= size())
+	{
+		return 0;
+	}
+	bool backward = buffer && (n < buffer_start);
+	if (backward)
+	{
+		stats.backward_misses++;
+		recent_backward_misses++;
+	}
+	else
+	{
+		stats.forward_misses++;
+		recent_forward_misses++;
+	}
+	// If backtracking is causing most of the misses, then the window is too
+	// small for this grammar, so grow it.  Rescanning forward after a backward
+	// miss usually causes a forward miss as well, so count backward misses
+	// twice.
+	if (recent_forward_misses + recent_backward_misses >= adapt_interval)
+	{
+		if ((recent_backward_misses * 2 >= recent_forward_misses) &&
+		    (window_size < max_window_size))
+		{
+			window_size = std::min(window_size * 2, max_window_size);
+		}
+		recent_forward_misses = 0;
+		recent_backward_misses = 0;
+	}
+	// Optimise backtracking by jumping back a quarter of the window so
+	// subsequent forward scans are fast.
+	Index back_seek = window_size / 4;
+	if (backward)
+	{
+		buffer_start = (n > back_seek) ? n - back_seek : 0;
+	}
+	else
+	{
+		buffer_start = n;
+	}
+	if (local_buffer_size < window_size)
+	{
+		local_buffer.reset(new char32_t[window_size]);
+		local_buffer_size = window_size;
+	}
+	Index length;
+	for (;;)
+	{
+		length = window_size;
+		buffer = local_buffer.get();
+		if (!fillBuffer(buffer_start, length, buffer))
+		{
+			buffer_end = 0;
+			return 0;
+		}
+		if (buffer == local_buffer.get())
+		{
+			stats.characters_fetched += length;
+		}
+		if ((n - buffer_start < length) || (buffer_start == n))
+		{
+			break;
+		}
+		// Inputs may return fewer characters than were asked for, so a
+		// window that starts before `n` can end before reaching it.  Fetch
+		// the window from `n` instead.
+		buffer_start = n;
+	}
+	buffer_end = buffer_start + length;
+	assert((n >= buffer_start) && (n < buffer_end));
+	return buffer[n - buffer_start];
+}
+void Input::setWindowSize(Index size, Index max_size)
+{
+	window_size = std::max(size, static_cast<Index>(1));
+	max_window_size = std::max(max_size, window_size);
+}
+Input::~Input() {}
+bool Input::available(Index n)
+{
+	return n < size();
+}
+void Input::release(Index)
+{
+}
+bool Input::byteSpan(Index, const uint8_t *&, Index &, Index &)
+{
+	return false;
+}
+bool Input::characterSpan(Index, const char32_t *&, Index &, Index &)
+{
+	return false;
+}
+bool  UnicodeVectorInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start > vector.size())
+	{
+		return false;
+	}
+	length = vector.size() - start;
+	// The buffer can't be const because this function is allowed to write into
+	// it, but the caller guarantees that it will not write to the returned
+	// value.
+	// We should probably clean up this interface to a const char32_t* instead
+	// of a bool...
+	b = const_cast<char32_t*>(vector.data() + start);
+	return true;
+}
+bool UnicodeVectorInput::characterSpan(Index, const char32_t *&data,
+                                       Index &start, Index &end)
+{
+	data = vector.data();
+	start = 0;
+	end = vector.size();
+	return true;
+}
+Input::Index UnicodeVectorInput::size() const
+{
+	return vector.size();
+}
+
+bool  StringInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start > str.size())
+	{
+		return false;
+	}
+	length = std::min(length, str.size() - start);
+	for (Index i=0 ; i<length ; i++)
+	{
+		b[i] = static_cast<char32_t>(static_cast<unsigned char>(str[start + i]));
+	}
+	return true;
+}
+bool StringInput::byteSpan(Index, const uint8_t *&data, Index &start, Index &end)
+{
+	data = reinterpret_cast<const uint8_t*>(str.data());
+	start = 0;
+	end = str.size();
+	return true;
+}
+Input::Index StringInput::size() const
+{
+	return str.size();
+}
+
+bool  StringViewInput::fillBuffer(Index start, Index &buffer_length, char32_t *&b)
+{
+	if (start > length)
+	{
+		return false;
+	}
+	buffer_length = std::min(buffer_length, length - start);
+	for (Index i=0 ; i<buffer_length ; i++)
+	{
+		b[i] = static_cast<char32_t>(static_cast<unsigned char>(str[start + i]));
+	}
+	return true;
+}
+bool StringViewInput::byteSpan(Index, const uint8_t *&data, Index &start, Index &end)
+{
+	data = reinterpret_cast<const uint8_t*>(str);
+	start = 0;
+	end = length;
+	return true;
+}
+Input::Index StringViewInput::size() const
+{
+	return length;
+}
+
+bool  UnicodeSpanInput::fillBuffer(Index start, Index &buffer_length, char32_t *&b)
+{
+	if (start > length)
+	{
+		return false;
+	}
+	buffer_length = length - start;
+	b = const_cast<char32_t*>(characters + start);
+	return true;
+}
+bool UnicodeSpanInput::characterSpan(Index, const char32_t *&data,
+                                     Index &start, Index &end)
+{
+	data = characters;
+	start = 0;
+	end = length;
+	return true;
+}
+Input::Index UnicodeSpanInput::size() const
+{
+	return length;
+}
+
+IovecInput::IovecInput(const struct iovec *iov, int count) : cursor(0)
+{
+	Index total = 0;
+	fragments.reserve(static_cast<size_t>(count) + 1);
+	for (int i=0 ; i<count ; i++)
+	{
+		if (iov[i].iov_len == 0)
+		{
+			continue;
+		}
+		fragments.push_back({ static_cast<const uint8_t*>(iov[i].iov_base), total });
+		total += iov[i].iov_len;
+	}
+	fragments.push_back({ nullptr, total });
+}
+size_t IovecInput::fragmentForIndex(Index n)
+{
+	assert(n < size());
+	// Check the most recently used fragment and the one after it, which will
+	// catch most sequential accesses.
+	if ((n >= fragments[cursor].start) && (n < fragments[cursor+1].start))
+	{
+		return cursor;
+	}
+	if ((cursor + 2 < fragments.size()) &&
+	    (n >= fragments[cursor+1].start) && (n < fragments[cursor+2].start))
+	{
+		return ++cursor;
+	}
+	auto it = std::upper_bound(fragments.begin(), fragments.end(), n,
+		[](Index i, const Fragment &f) { return i < f.start; });
+	cursor = static_cast<size_t>(it - fragments.begin()) - 1;
+	return cursor;
+}
+bool  IovecInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start >= size())
+	{
+		return false;
+	}
+	// Copy from as many fragments as it takes to fill the window, so that a
+	// window starting before the index that missed reaches it.
+	Index end = std::min(start + length, size());
+	Index n = start;
+	char32_t *out = b;
+	for (size_t i = fragmentForIndex(start) ; n < end ; i++)
+	{
+		const uint8_t *data = fragments[i].data + (n - fragments[i].start);
+		Index fragment_end = std::min(fragments[i+1].start, end);
+		for ( ; n < fragment_end ; n++)
+		{
+			*out++ = static_cast<char32_t>(*data++);
+		}
+	}
+	length = end - start;
+	return true;
+}
+bool IovecInput::byteSpan(Index n, const uint8_t *&data, Index &start, Index &end)
+{
+	if (n >= size())
+	{
+		return false;
+	}
+	size_t i = fragmentForIndex(n);
+	data = fragments[i].data;
+	start = fragments[i].start;
+	end = fragments[i+1].start;
+	return true;
+}
+Input::Index IovecInput::size() const
+{
+	return fragments.back().start;
+}
+
+/**
+ * The buffers for a `PrefetchFileInput` and the state that is shared with the
+ * thread that fills them.
+ */
+struct PrefetchFileInput::Prefetcher
+{
+	/**
+	 * A buffer, holding one block of the file.
+	 */
+	struct Slot
+	{
+		/**
+		 * The data for this block.
+		 */
+		std::unique_ptr<uint8_t[]> data;
+		/**
+		 * The number of the block that this slot holds, or is being filled
+		 * with, or npos if it is empty.
+		 */
+		Index block = npos;
+		/**
+		 * Flag indicating that the background thread has finished filling
+		 * this slot.
+		 */
+		bool ready = false;
+	};
+	/**
+	 * The file descriptor to read from.
+	 */
+	int fd;
+	/**
+	 * The size of the file.
+	 */
+	size_t file_size;
+	/**
+	 * The size of each block.
+	 */
+	size_t block_size;
+	/**
+	 * The buffers.
+	 */
+	std::vector<Slot> slots;
+	/**
+	 * The block most recently requested by the parser.  The background thread
+	 * reads the blocks that follow this one.
+	 */
+	Index head = 0;
+	/**
+	 * The block most recently returned from `byteSpan()`, which must not be
+	 * recycled.
+	 */
+	Index pinned = npos;
+	/**
+	 * Flag set to tell the background thread to exit.
+	 */
+	bool stop = false;
+	/**
+	 * Flag set once the background thread has found the file to be shorter
+	 * than its size when opened.  This is only used by that thread.
+	 */
+	bool truncated = false;
+	/**
+	 * Lock protecting all of the state in this structure.
+	 */
+	std::mutex lock;
+	/**
+	 * Condition variable used to wake the background thread when the parser
+	 * requests a new block, and to wake the parser when a block is ready.
+	 */
+	std::condition_variable changed;
+	/**
+	 * The background thread.
+	 */
+	std::thread thread;
+
+	Prefetcher(int file, size_t size, size_t block, unsigned count) :
+		fd(file), file_size(size), block_size(block), slots(count)
+	{
+		for (Slot &s : slots)
+		{
+			s.data.reset(new uint8_t[block_size]);
+		}
+		thread = std::thread([this]() { run(); });
+	}
+
+	~Prefetcher()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stop = true;
+		}
+		changed.notify_all();
+		thread.join();
+	}
+
+	/**
+	 * Returns the number of blocks in the file.
+	 */
+	Index block_count() const
+	{
+		return (file_size + block_size - 1) / block_size;
+	}
+
+	/**
+	 * Returns the slot holding (or being filled with) `block`, or null if
+	 * there isn't one.  Must be called with the lock held.
+	 */
+	Slot *find(Index block)
+	{
+		for (Slot &s : slots)
+		{
+			if (s.block == block)
+			{
+				return &s;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Returns true if `block` should be kept in memory: it is either the
+	 * pinned block or one of the blocks starting from the head that fit in the
+	 * remaining buffers.  Must be called with the lock held.
+	 */
+	bool wanted(Index block) const
+	{
+		Index window = slots.size() - ((pinned != npos) && (pinned != head) ? 1 : 0);
+		return (block == pinned) ||
+		       ((block >= head) && (block - head < window));
+	}
+
+	/**
+	 * Body of the background thread.  Reads the first wanted block that isn't
+	 * already in memory into a buffer that holds a block that isn't wanted.
+	 */
+	void run()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (!stop)
+		{
+			Index next = npos;
+			Index end = std::min(block_count(), head + slots.size());
+			if ((pinned != npos) && !find(pinned))
+			{
+				next = pinned;
+			}
+			for (Index b = head ; (next == npos) && (b < end) ; b++)
+			{
+				if (wanted(b) && !find(b))
+				{
+					next = b;
+				}
+			}
+			Slot *slot = nullptr;
+			if (next != npos)
+			{
+				for (Slot &s : slots)
+				{
+					if ((s.block == npos) || (s.ready && !wanted(s.block)))
+					{
+						slot = &s;
+						break;
+					}
+				}
+			}
+			if (!slot)
+			{
+				changed.wait(guard);
+				continue;
+			}
+			slot->block = next;
+			slot->ready = false;
+			uint8_t *data = slot->data.get();
+			guard.unlock();
+			size_t offset = next * block_size;
+			size_t length = std::min(block_size, file_size - offset);
+			size_t done = 0;
+			while (done < length)
+			{
+				ssize_t r = pread(fd, data + done, length - done,
+				                  static_cast<off_t>(offset + done));
+				if ((r < 0) && (errno == EINTR))
+				{
+					continue;
+				}
+				if (r <= 0)
+				{
+					// A read of nothing means that the file was truncated
+					// after its size was taken, which isn't an I/O error.
+					// Every later block will be short too, so report it once.
+					if (r < 0)
+					{
+						perror("Input error");
+					}
+					else if (!truncated)
+					{
+						fprintf(stderr, "Input error: file truncated while "
+						        "reading\n");
+						truncated = true;
+					}
+					memset(data + done, 0, length - done);
+					break;
+				}
+				done += static_cast<size_t>(r);
+			}
+			guard.lock();
+			slot->ready = true;
+			changed.notify_all();
+		}
+	}
+
+	/**
+	 * Waits until `block` is in memory and returns its slot.  Must be called
+	 * with the lock held, via `guard`.
+	 */
+	Slot &acquire(Index block, std::unique_lock<std::mutex> &guard)
+	{
+		if (head != block)
+		{
+			head = block;
+			changed.notify_all();
+		}
+		Slot *s;
+		while (!(s = find(block)) || !s->ready)
+		{
+			changed.wait(guard);
+		}
+		return *s;
+	}
+};
+
+const std::size_t PrefetchFileInput::default_block_size;
+const unsigned PrefetchFileInput::default_block_count;
+PrefetchFileInput::PrefetchFileInput(int file, size_t block_size, unsigned block_count)
+{
+	struct stat buf;
+	if (fstat(file, &buf) != 0)
+	{
+		file_size = 0;
+		perror("Input error");
+		return;
+	}
+	file_size = static_cast<Index>(buf.st_size);
+	if (file_size == 0)
+	{
+		return;
+	}
+	if (block_size == 0)
+	{
+		block_size = default_block_size;
+	}
+	prefetcher.reset(new Prefetcher(file, file_size, block_size,
+	                                std::max(block_count, 2U)));
+}
+PrefetchFileInput::~PrefetchFileInput() {}
+bool PrefetchFileInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start >= file_size)
+	{
+		return false;
+	}
+	Prefetcher &p = *prefetcher;
+	std::unique_lock<std::mutex> guard(p.lock);
+	// Copy from as many blocks as it takes to fill the window, so that a
+	// window starting before the index that missed reaches it.  A slot can't
+	// be recycled while we hold the lock, so each block is copied out of its
+	// slot before waiting for the next.
+	Index end = std::min(start + length, file_size);
+	Index n = start;
+	char32_t *out = b;
+	for (Index block = start / p.block_size ; n < end ; block++)
+	{
+		Prefetcher::Slot &slot = p.acquire(block, guard);
+		Index block_start = block * p.block_size;
+		Index block_end = std::min(block_start + p.block_size, end);
+		const uint8_t *data = slot.data.get() + (n - block_start);
+		for ( ; n < block_end ; n++)
+		{
+			*out++ = static_cast<char32_t>(*data++);
+		}
+	}
+	length = end - start;
+	return true;
+}
+bool PrefetchFileInput::byteSpan(Index n, const uint8_t *&data, Index &start, Index &end)
+{
+	if (n >= file_size)
+	{
+		return false;
+	}
+	Prefetcher &p = *prefetcher;
+	std::unique_lock<std::mutex> guard(p.lock);
+	Index block = n / p.block_size;
+	// Pin the block before waiting for it, so that the background thread
+	// doesn't recycle it once it has been read.
+	p.pinned = block;
+	Prefetcher::Slot &slot = p.acquire(block, guard);
+	data = slot.data.get();
+	start = block * p.block_size;
+	end = std::min(start + p.block_size, file_size);
+	return true;
+}
+Input::Index PrefetchFileInput::size() const
+{
+	return file_size;
+}
+
+const std::size_t StreamInput::default_chunk_size;
+StreamInput::StreamInput(int file, size_t chunk) :
+	fd(file),
+	chunk_size(chunk ? chunk : default_chunk_size),
+	read_end(0),
+	eof(false)
+{
+}
+StreamInput::Chunk *StreamInput::chunkForIndex(Index n)
+{
+	if (!available(n) || chunks.empty() || (n < chunks.front().start))
+	{
+		return nullptr;
+	}
+	return &chunks[(n - chunks.front().start) / chunk_size];
+}
+bool StreamInput::available(Index n)
+{
+	while (!eof && (n >= read_end))
+	{
+		// Start a new chunk if the last one is full, reusing the storage from
+		// a discarded chunk if possible.
+		if (chunks.empty() || (chunks.back().length == chunk_size))
+		{
+			Chunk c;
+			if (spare.empty())
+			{
+				c.data.reset(new uint8_t[chunk_size]);
+			}
+			else
+			{
+				c.data = std::move(spare.back());
+				spare.pop_back();
+			}
+			c.start = read_end;
+			c.length = 0;
+			chunks.push_back(std::move(c));
+		}
+		Chunk &c = chunks.back();
+		ssize_t r = read(fd, c.data.get() + c.length, chunk_size - c.length);
+		if ((r < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+		if (r <= 0)
+		{
+			if (r < 0)
+			{
+				perror("Input error");
+			}
+			eof = true;
+			break;
+		}
+		c.length += static_cast<size_t>(r);
+		read_end += static_cast<Index>(r);
+	}
+	return n < read_end;
+}
+void StreamInput::release(Index n)
+{
+	// Never discard the last chunk, as it may still be being filled.
+	while ((chunks.size() > 1) && (chunks.front().start + chunk_size <= n))
+	{
+		// Keep a couple of chunks around for reuse, so that steady-state
+		// parsing doesn't allocate.
+		if (spare.size() < 2)
+		{
+			spare.push_back(std::move(chunks.front().data));
+		}
+		chunks.pop_front();
+	}
+}
+bool  StreamInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (!chunkForIndex(start))
+	{
+		return false;
+	}
+	// Copy from as many chunks as have been read and are needed to fill the
+	// window, so that a window starting before the index that missed
+	// reaches it.  Chunks are contiguous, and all but the last are full.
+	Index end = std::min(start + length, read_end);
+	Index n = start;
+	char32_t *out = b;
+	for (size_t i = (start - chunks.front().start) / chunk_size ; n < end ; i++)
+	{
+		const Chunk &c = chunks[i];
+		const uint8_t *data = c.data.get() + (n - c.start);
+		Index chunk_end = std::min(c.start + c.length, end);
+		for ( ; n < chunk_end ; n++)
+		{
+			*out++ = static_cast<char32_t>(*data++);
+		}
+	}
+	length = end - start;
+	return true;
+}
+bool StreamInput::byteSpan(Index n, const uint8_t *&data, Index &start, Index &end)
+{
+	Chunk *c = chunkForIndex(n);
+	if (!c)
+	{
+		return false;
+	}
+	data = c->data.get();
+	start = c->start;
+	end = c->start + c->length;
+	return true;
+}
+Input::Index StreamInput::size() const
+{
+	return eof ? read_end : npos;
+}
+
+/**
+ * Returns the length of the run of ASCII characters at the start of the
+ * `length` bytes starting at `s`.  Uses SSE2 to check 16 bytes at a time, if
+ * available, or falls back to checking a word at a time.
+ */
+static inline size_t asciiPrefixLength(const unsigned char *s, size_t length)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for ( ; i + 16 <= length ; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		int mask = _mm_movemask_epi8(v);
+		if (mask != 0)
+		{
+			return i + static_cast<size_t>(__builtin_ctz(mask));
+		}
+	}
+#else
+	for ( ; i + 8 <= length ; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, s + i, 8);
+		if ((word & 0x8080808080808080ULL) != 0)
+		{
+			break;
+		}
+	}
+#endif
+	while ((i < length) && (s[i] < 0x80))
+	{
+		i++;
+	}
+	return i;
+}
+
+/**
+ * Widens `length` ASCII bytes from `s` into `b`.  The caller is responsible
+ * for ensuring that all of the bytes are ASCII.
+ */
+static inline void widenASCII(const unsigned char *s, char32_t *b, size_t length)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	for ( ; i + 16 <= length ; i += 16)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		__m128i *out = reinterpret_cast<__m128i*>(b + i);
+		_mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+	}
+#endif
+	for ( ; i < length ; i++)
+	{
+		b[i] = static_cast<char32_t>(s[i]);
+	}
+}
+
+/**
+ * Decodes a single (non-ASCII) UTF-8 sequence starting at `s`, with `end`
+ * marking the end of the buffer.  The decoded character is returned via `c`
+ * and the length of the sequence is returned.  Malformed sequences (including
+ * overlong encodings, surrogates and values outside of the Unicode range) are
+ * decoded as a single byte, producing U+FFFD, and `ok` is set to false.
+ */
+static inline size_t decodeUTF8(const unsigned char *s,
+                                const unsigned char *end,
+                                char32_t &c,
+                                bool &ok)
+{
+	unsigned char lead = s[0];
+	size_t length;
+	char32_t min;
+	if (lead < 0x80)
+	{
+		c = lead;
+		return 1;
+	}
+	else if ((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		min = 0x80;
+		c = lead & 0x1F;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		min = 0x800;
+		c = lead & 0x0F;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		min = 0x10000;
+		c = lead & 0x07;
+	}
+	else
+	{
+		length = 0;
+		min = 0;
+	}
+	if ((length == 0) || (static_cast<size_t>(end - s) < length))
+	{
+		length = 0;
+	}
+	for (size_t i=1 ; i<length ; i++)
+	{
+		if ((s[i] & 0xC0) != 0x80)
+		{
+			length = 0;
+			break;
+		}
+		c = (c << 6) | (s[i] & 0x3F);
+	}
+	if ((length == 0) || (c < min) || (c > 0x10FFFF) ||
+	    ((c >= 0xD800) && (c <= 0xDFFF)))
+	{
+		ok = false;
+		c = 0xFFFD;
+		return 1;
+	}
+	return length;
+}
+
+const Input::Index Utf8Input::checkpoint_interval;
+void Utf8Input::scan()
+{
+	const unsigned char *s = reinterpret_cast<const unsigned char*>(str.data());
+	const size_t byte_length = str.size();
+	size_t offset = 0;
+	Index cp = 0;
+	valid = true;
+	ascii = true;
+	checkpoints.clear();
+	checkpoints.reserve(byte_length / checkpoint_interval + 1);
+	while (offset < byte_length)
+	{
+		// Skip over a run of ASCII characters.  Each character in the run is
+		// one byte, so the checkpoints within it can be computed directly.
+		size_t run = asciiPrefixLength(s + offset, byte_length - offset);
+		for (Index next = checkpoints.size() * checkpoint_interval ;
+		     next < cp + run ; next += checkpoint_interval)
+		{
+			checkpoints.push_back(offset + (next - cp));
+		}
+		offset += run;
+		cp += run;
+		if (offset == byte_length)
+		{
+			break;
+		}
+		// Decode a single multi-byte character
+		ascii = false;
+		if (cp % checkpoint_interval == 0)
+		{
+			checkpoints.push_back(offset);
+		}
+		char32_t c;
+		offset += decodeUTF8(s + offset, s + byte_length, c, valid);
+		cp++;
+	}
+	length = cp;
+	cursor_index = 0;
+	cursor_offset = 0;
+}
+
+size_t Utf8Input::byteOffset(Index n) const
+{
+	if (n >= length)
+	{
+		return str.size();
+	}
+	if (ascii)
+	{
+		return n;
+	}
+	const unsigned char *s = reinterpret_cast<const unsigned char*>(str.data());
+	const unsigned char *end = s + str.size();
+	size_t offset = checkpoints[n / checkpoint_interval];
+	bool ok;
+	char32_t c;
+	for (Index i = n - (n % checkpoint_interval) ; i < n ; i++)
+	{
+		offset += decodeUTF8(s + offset, end, c, ok);
+	}
+	return offset;
+}
+
+std::pair<const char*, size_t> Utf8Input::bytes(const InputRange &r) const
+{
+	size_t start = byteOffset(r.begin().index());
+	size_t end = byteOffset(r.end().index());
+	return std::make_pair(str.data() + start, end - start);
+}
+
+bool Utf8Input::fillBuffer(Index start, Index &buffer_length, char32_t *&b)
+{
+	if (start > length)
+	{
+		return false;
+	}
+	buffer_length = std::min(buffer_length, length - start);
+	const unsigned char *s = reinterpret_cast<const unsigned char*>(str.data());
+	const unsigned char *end = s + str.size();
+	size_t offset = (start == cursor_index) ? cursor_offset : byteOffset(start);
+	bool ok;
+	Index i = 0;
+	while (i < buffer_length)
+	{
+		size_t run = asciiPrefixLength(s + offset,
+		                               std::min(static_cast<size_t>(end - s) - offset,
+		                                        buffer_length - i));
+		widenASCII(s + offset, b + i, run);
+		i += run;
+		offset += run;
+		if (i < buffer_length)
+		{
+			offset += decodeUTF8(s + offset, end, b[i++], ok);
+		}
+	}
+	cursor_index = start + buffer_length;
+	cursor_offset = offset;
+	return true;
+}
+
+bool Utf8Input::byteSpan(Index, const uint8_t *&data, Index &start, Index &end)
+{
+	if (!ascii)
+	{
+		return false;
+	}
+	data = reinterpret_cast<const uint8_t*>(str.data());
+	start = 0;
+	end = str.size();
+	return true;
+}
+
+Input::Index Utf8Input::size() const
+{
+	return length;
+}
+
+AsciiFileInput::AsciiFileInput(int file) : fd(file)
+{
+	struct stat buf;
+	if (fstat(fd, &buf) != 0)
+	{
+		file_size = 0;
+		perror("Input error");
+	}
+	else
+	{
+		file_size = static_cast<Index>(buf.st_size);
+	}
+}
+
+const std::size_t Input::static_buffer_size;
+const std::size_t Input::default_max_window_size;
+/**
+ * Reads `length` bytes from `fd`, starting at `start`, into `b`, widening each
+ * to a character.
+ */
+static void preadCharacters(int fd, Input::Index start, Input::Index length, char32_t *b)
+{
+	unsigned char buffer[4096];
+	for (Input::Index done=0 ; done<length ; )
+	{
+		size_t chunk = std::min(length - done, sizeof(buffer));
+		pread(fd, buffer, chunk, static_cast<off_t>(start + done));
+		for (size_t i=0 ; i<chunk ; i++)
+		{
+			b[done + i] = static_cast<char32_t>(buffer[i]);
+		}
+		done += chunk;
+	}
+}
+bool AsciiFileInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start > file_size)
+	{
+		return false;
+	}
+	length = std::min(length, file_size - start);
+	preadCharacters(fd, start, length, b);
+	return true;
+}
+Input::Index AsciiFileInput::size() const
+{
+	return file_size;
+}
+
+MmapFileInput::MmapFileInput(int file) :
+	fd(file), file_size(0), data(nullptr), advised_end(0)
+{
+	struct stat buf;
+	if (fstat(fd, &buf) != 0)
+	{
+		perror("Input error");
+		return;
+	}
+	file_size = static_cast<Index>(buf.st_size);
+	if (file_size == 0)
+	{
+		return;
+	}
+	void *addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (addr == MAP_FAILED)
+	{
+		// Leave data as null, fillBuffer() will fall back to pread().
+		return;
+	}
+	data = static_cast<const unsigned char*>(addr);
+	madvise(addr, file_size, MADV_SEQUENTIAL);
+}
+
+MmapFileInput::~MmapFileInput()
+{
+	if (data)
+	{
+		munmap(const_cast<unsigned char*>(data), file_size);
+	}
+}
+
+const std::size_t MmapFileInput::readahead_size;
+void MmapFileInput::advise(Index start, Index end)
+{
+	// The start of each block is a multiple of the block size from the start
+	// of the mapping, and so is always page aligned.
+	advised_end = std::max(advised_end, start - (start % readahead_size));
+	while ((advised_end < end) && (advised_end < file_size))
+	{
+		size_t advise_length = std::min(readahead_size,
+		                                file_size - advised_end);
+		madvise(const_cast<unsigned char*>(data + advised_end),
+		        advise_length, MADV_WILLNEED);
+		advised_end += advise_length;
+	}
+}
+bool MmapFileInput::fillBuffer(Index start, Index &length, char32_t *&b)
+{
+	if (start > file_size)
+	{
+		return false;
+	}
+	length = std::min(length, file_size - start);
+	if (!data)
+	{
+		preadCharacters(fd, start, length, b);
+		return true;
+	}
+	// If we're getting close to the end of the range that we've asked the
+	// kernel to fetch, then ask for the next block.
+	advise(start, start + length + readahead_size / 2);
+	const unsigned char *src = data + start;
+	for (Index i=0 ; i<length ; i++)
+	{
+		b[i] = static_cast<char32_t>(src[i]);
+	}
+	return true;
+}
+bool MmapFileInput::byteSpan(Index n, const uint8_t *&d, Index &start, Index &end)
+{
+	if (!data || (n > file_size))
+	{
+		return false;
+	}
+	// Hand out one block at a time, so that the parser comes back to us as
+	// it moves through the file and we can keep the kernel fetching the
+	// block after the one being parsed.
+	start = n - (n % readahead_size);
+	end = std::min(start + readahead_size, file_size);
+	advise(start, end + readahead_size);
+	d = data + start;
+	return true;
+}
+Input::Index MmapFileInput::size() const
+{
+	return file_size;
+}
+
+/** constructor from input.
+	@param i input.
+ */
+ParserPosition::ParserPosition(Input &i) :
+	it(i.begin()),
+	line(1),
+	col(1)
+{
+}
+
+/** creates a zero-or-more loop out of this expression.
+	@return a zero-or-more loop expression.
+ */
+ExprPtr operator *(const ExprPtr &e)
+{
+	return ExprPtr(new Loop0Expr(e));
+}
+
+
+/** creates a one-or-more loop out of this expression.
+	@return a one-or-more loop expression.
+ */
+ExprPtr operator +(const ExprPtr &e)
+{
+	return ExprPtr(new Loop1Expr(e));
+}
+
+
+/** creates an optional out of e expression.
+	@return an optional expression.
+ */
+ExprPtr operator -(const ExprPtr &e)
+{
+	return ExprPtr(new OptionalExpr(e));
+}
+
+
+/** creates an AND-expression.
+	@return an AND-expression.
+ */
+ExprPtr operator &(const ExprPtr &e)
+{
+	return ExprPtr(new AndExpr(e));
+}
+
+
+/** creates a NOT-expression.
+	@return a NOT-expression.
+ */
+ExprPtr operator !(const ExprPtr &e)
+{
+	return ExprPtr(new NotExpr(e));
+}
+
+
+/** constructor.
+	@param b begin position.
+	@param e end position.
+ */
+InputRange::InputRange(const ParserPosition &b, const ParserPosition &e) : start(b), finish(e) { }
+
+std::string InputRange::str() const
+{
+	std::stringstream s;
+
+	for (char c : *this)
+	{
+		s << c;
+	}
+
+	return s.str();
+}
+
+
+/** constructor.
+	@param b begin position.
+	@param e end position.
+	@param t error type.
+ */
+Error::Error(const ParserPosition &b, const ParserPosition &e, int t) :
+	InputRange(b, e), error_type(t) { }
+
+
+/** compare on begin position.
+	@param e the other error to compare this with.
+	@return true if this comes before the previous error, false otherwise.
+ */
+bool Error::operator < (const Error &e) const
+{
+	return start.it < e.start.it;
+}
+
+Rule::Rule(const ExprPtr e) :
+	expr(e), memo_policy(MEMO_ALWAYS), memo_state(MEMO_ALWAYS),
+	id(next_rule_id++)
+{
+	programs[0] = nullptr;
+	programs[1] = nullptr;
+	generated[0] = nullptr;
+	generated[1] = nullptr;
+	first_sets[0] = nullptr;
+	first_sets[1] = nullptr;
+	grammar_layout = nullptr;
+}
+
+Rule::~Rule()
+{
+	delete programs[0].load();
+	delete programs[1].load();
+	delete first_sets[0].load();
+	delete first_sets[1].load();
+	delete grammar_layout.load();
+}
+
+const GrammarLayout &Rule::layout(const Rule &ws) const
 {
-public:
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	const GrammarLayout *l = grammar_layout.load(std::memory_order_acquire);
+	if (l)
 	{
-		return parse_term(con);
+		return *l;
 	}
-
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	std::unique_ptr<GrammarLayout> built(new GrammarLayout(*this, ws));
+	// Another thread may have numbered the grammar at the same time, in
+	// which case use its version.
+	if (grammar_layout.compare_exchange_strong(l, built.get(),
+	                                           std::memory_order_acq_rel))
 	{
-		return con.end();
+		return *built.release();
 	}
+	return *l;
+}
 
-	virtual void dump() const
+const Program &Rule::program(bool term) const
+{
+	std::atomic<const Program*> &slot = programs[term ? 1 : 0];
+	const Program *p = slot.load(std::memory_order_acquire);
+	if (p)
 	{
-		fprintf(stderr, "$eof");
+		return *p;
 	}
-};
-
-
-//AnyExpr
-class AnyExpr : public Expr
-{
-public:
-	//parse with whitespace
-	virtual bool parse_non_term(Context &con) const
+	std::unique_ptr<Program> compiled(new Program());
+	ProgramBuilder b(*compiled);
+	b.expr(expr, term);
+	b.emit(OP_RETURN);
+	if (compiled->code.size() == 2)
 	{
-		return parse_term(con);
+		// Strings and sets that the builder made from the rule's expression
+		// match the same input in both modes, and are cheaper to walk.
+		const Instruction &only = compiled->code[0];
+		bool made = (only.op == OP_STRING) || (only.op == OP_SET);
+		compiled->direct = made ? only.expr : expr.get();
 	}
-
-	//parse terminal
-	virtual bool parse_term(Context &con) const
+	// FNV-1a, over everything except the addresses of expressions and rules.
+	// Every operand that `generateParser()` writes into the generated code
+	// must be included, so that code generated from a different version of
+	// the grammar is rejected.
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&](uint64_t v)
+		{
+			hash = (hash ^ v) * 1099511628211ULL;
+		};
+	for (const Instruction &i : compiled->code)
 	{
-		if (!con.end())
+		mix(i.op);
+		mix(i.arg);
+		switch (i.op)
 		{
-			con.next_col();
-			return true;
+		case OP_SET:
+		case OP_SPAN:
+		{
+			const SetExpr *set = static_cast<const SetExpr*>(i.expr);
+			for (char32_t c = 0; c < set->limit(); c++)
+			{
+				mix(set->contains(c));
+			}
+			break;
 		}
-		con.set_error_pos();
-		return false;
-	}
-
-	virtual void dump() const
-	{
-		fprintf(stderr, "$AnyExpr");
-	}
-};
-/**
- * Trace expressions have no effect on parsing.  They wrap another expression
- * and log a message when parsing for it begins and ends, along with whether it
- * succeeds.
- */
-class TraceExpr : public Expr
-{
-	/**
-	 * The message to log for this expression.
-	 */
-	const char *message;
-	/**
-	 * The real expression that will handle the parsing.
-	 */
-	const ExprPtr expr;
-	void log(int depth, const char *event, const char *result, Context &con) const
-	{
-		fprintf(stderr, "[%d] ", depth);
-		for (int i=0 ; i<depth ; i++)
+		case OP_STRING:
 		{
-			fprintf(stderr, " ");
+			const std::vector<char32_t> &chars =
+				static_cast<const StringExpr*>(i.expr)->chars();
+			mix(chars.size());
+			for (char32_t c : chars)
+			{
+				mix(c);
+			}
+			break;
+		}
+		case OP_DISPATCH:
+			mix(i.dispatch->entries.size());
+			for (uint32_t entry : i.dispatch->entries)
+			{
+				mix(entry);
+			}
+			break;
+		default:
+			break;
 		}
-		fprintf(stderr, "%s %s (line %d, column %d)\n",
-		                event,
-		                result,
-		                con.position.line,
-		                con.position.col);
-	}
-public:
-	TraceExpr(const char *m, const ExprPtr e) : message(m), expr(e) {}
-
-	virtual bool parse_non_term(Context &con) const
-	{
-		log(con.depth++, "Trying", message, con);
-		bool result = expr->parse_non_term(con);
-		log(--con.depth, message, result ? "succeeded" : "failed", con);
-		return result;
 	}
-	virtual bool parse_term(Context &con) const
+	compiled->fingerprint = hash;
+	// Another thread may have compiled the rule at the same time, in which
+	// case use its version.
+	if (slot.compare_exchange_strong(p, compiled.get(),
+	                                 std::memory_order_acq_rel))
 	{
-		log(con.depth++, "Trying", message, con);
-		bool result = expr->parse_term(con);
-		log(--con.depth, message, result ? "succeeded" : "failed", con);
-		return result;
+		return *compiled.release();
 	}
+	return *p;
+}
 
-	virtual void dump() const
-	{
-		expr->dump();
-	}
-};
-class DebugExpr : public Expr
+void Rule::setMemoPolicy(MemoPolicy p)
 {
-	std::function<void()> fn;
-public:
-	DebugExpr(std::function<void()> f) : fn(f) {}
+	memo_policy = p;
+	memo_state = p;
+}
 
-	//parse with whitespace
-	virtual bool parse_non_term(Context &) const
-	{
-		fn();
-		return true;
-	}
 
-	//parse terminal
-	virtual bool parse_term(Context &) const
-	{
-		fn();
-		return true;
-	}
+/** constructor from rule.
+	@param r rule.
+ */
+ExprPtr::ExprPtr(const char *s) : std::shared_ptr<Expr>(new StringExpr(s)) {}
+ExprPtr::ExprPtr(const char32_t s) : std::shared_ptr<Expr>(new CharacterExpr(s)) {}
+ExprPtr::ExprPtr(const Rule &r) : std::shared_ptr<Expr>(new RuleReferenceExpr(r)) {}
 
-	virtual void dump() const
-	{
-		fprintf(stderr, "<DEBUG: ");
-		fn();
-		fprintf(stderr, ">");
-	}
-};
 
-//constructor
-ParsingState::ParsingState(Context &con) :
-	position(con.position),
-	matches(con.matches.size())
+/** creates a sequence of expressions.
+	@param left left operand.
+	@param right right operand.
+	@return an expression which parses a sequence.
+ */
+ExprPtr operator >> (const ExprPtr &left, const ExprPtr &right)
 {
+	return ExprPtr(new SequenceExpr(left, right));
 }
 
-static inline bool parseString(Context &con,
-                               const std::vector<char32_t> &characters)
+
+/** creates a choice of expressions.
+	@param left left operand.
+	@param right right operand.
+	@return an expression which parses a choice.
+ */
+ExprPtr operator | (const ExprPtr &left, const ExprPtr &right)
 {
-	for (char32_t c : characters)
-	{
-		if (con.end() || con.symbol() != c)
-		{
-			con.set_error_pos();
-			return false;
-		}
-		con.next_col();
-	}
-	return true;
+	return ExprPtr(new ChoiceExpr(left, right));
 }
-bool StringExpr::parse_non_term(Context &con) const
+
+
+/** converts a parser expression into a terminal.
+	@param e expression.
+	@return an expression which parses a terminal.
+ */
+ExprPtr term(const ExprPtr &e)
 {
-	return parseString(con, characters);
+	return ExprPtr(new TerminalExpr(e));
 }
-bool StringExpr::parse_term(Context &con) const
+
+
+/** creates a set expression from a null-terminated string.
+	@param s null-terminated string with characters of the set.
+	@return an expression which parses a single character out of a set.
+ */
+ExprPtr set(const char *s)
 {
-	return parseString(con, characters);
+	return ExprPtr(new SetExpr(s));
 }
-void StringExpr::dump() const
+
+/**
+ * Creates a regex expression from the specified string.
+ */
+ExprPtr regex(const char *s)
 {
-	fprintf(stderr, "\"");
-	for (char32_t c : characters)
-	{
-		fprintf(stderr, "%c", static_cast<char>(c));
-	}
-	fprintf(stderr, "\"");
+	return ExprPtr(new RegexExpr<char>(s));
 }
 
+/**
+ * Creates a regex expression from the specified wide string.
+ */
+ExprPtr regex(const wchar_t *s)
+{
+	return ExprPtr(new RegexExpr<wchar_t>(s));
+}
+ExprPtr operator "" _R(const char *x, std::size_t len)
+{
+	return ExprPtr(new RegexExpr<char>(x, len));
+}
 
 
+/** creates a range expression.
+	@param min min character.
+	@param max max character.
+	@return an expression which parses a single character out of range.
+ */
+ExprPtr range(char32_t min, char32_t max)
+{
+	return ExprPtr(new SetExpr(min, max));
 }
 
-namespace pegmatite {
 
+/** creates an expression which increments the line counter
+	and resets the column counter when the given expression
+	is parsed successfully; used for newline characters.
+	@param e expression to wrap into a newline parser.
+	@return an expression that handles newlines.
+ */
+ExprPtr nl(const ExprPtr &e)
+{
+	return ExprPtr(new NewlineExpr(e));
+}
 
-//parse non-term rule.
-bool Context::parse_non_term(const Rule &r)
+
+/** creates an expression which tests for the end of input.
+	@return an expression that handles the end of input.
+ */
+ExprPtr eof()
 {
-	return parse_rule(r, &Context::_parse_non_term);
+	return ExprPtr(new EndOfFileExpr());
 }
 
-bool Context::parse_rule(const Rule &r, bool (Context::*parse_func)(const Rule &))
+
+
+/** creates an expression that parses any character.
+	@return the appropriate expression.
+ */
+ExprPtr any()
 {
-	// For each rule, we maintain a vector consisting of where it was last
-	// encountered (in the input stream) and what the parsing mode was.
-	auto &states = rule_states[std::addressof(r)];
-	// If this is the first time that we've encountered this rule, then set the
-	// last position and mode to values that will trigger a normal parse: We
-	// can't be in left recursion if this is the first time that we've
-	// encountered the rule.
-	size_t last_pos = Input::npos;
-	MatchMode last_mode = PARSE;
-	if (!states.empty())
-	{
-		auto &last = states.back();
-		last_pos = last.position;
-		last_mode = last.mode;
-	}
+	return ExprPtr(new AnyExpr());
+}
 
-	// Return value (success or failure of parse)
-	bool ok;
+ExprPtr commit()
+{
+	return ExprPtr(new CutExpr());
+}
 
-	// Compute the new position in the stream.  We're only tracking offsets to
-	// detect left recursion, not storing iterators.
-	size_t new_pos = position.it - start;
+ExprPtr debug(std::function<void()> fn)
+{
+	return ExprPtr(new DebugExpr(fn));
+}
+#ifdef DEBUG_PARSING
+ExprPtr trace_debug(const char *msg, const ExprPtr e)
+{
+	return ExprPtr(new TraceExpr(msg, e));
+}
+#endif
 
-	// Check if we have left recursion.  We are in a left-recursive state if
-	// the last time that we encountered this rule was at the same point in the
-	// input.
-	bool lr = new_pos == last_pos;
 
-	// Look up the current rule and parser position in the cache to see if
-	// we've been here before and successfully parsed the rule.
-	CacheKey k = { std::addressof(r), position.it };
-	auto cache_entry = cache.find(k);
-	if (cache_entry != cache.end())
-	{
-		// If we have a cache entry then grab the list of matched rules and the
-		// end parsing position from the cache and don't bother trying to apply
-		// the rules again.
-		auto cached_matches = cache_entry->second.second;
-		matches.insert(matches.end(), cached_matches.begin(), cached_matches.end());
-		position = cache_entry->second.first;
-		return true;
-	}
+/**
+ * Parses the input in the context `con`, starting from the rule `g`.  If this
+ * succeeds, then the parse procedures are run with `d` as the user data.
+ */
+static bool parseGrammar(Context &con, const Rule &g, ErrorList &el, void *d)
+{
+	con.user_data = d;
 
-	size_t new_match_index = matches.size();
+	//parse initial whitespace
+	con.parse_term(con.whitespace_rule);
 
-	switch (last_mode)
+	//parse grammar
+	if (!con.parse_non_term(g))
 	{
-		//normal parse
-		case PARSE:
-			if (lr)
-			{
-				//first try to parse the rule by rejecting it, so alternative
-				//branches are examined
-				states.push_back(RuleState(new_pos, REJECT));
-				ok = (this->*parse_func)(r);
-				states.pop_back();
-				break;
-			}
-			else
-			{
-				states.push_back(RuleState(new_pos, PARSE));
-				ok = (this->*parse_func)(r);
-				states.pop_back();
-			}
-			break;
-		case REJECT:
-			if (lr)
-			{
-				ok = false;
-			}
-			else
-			{
-				states.push_back(RuleState(new_pos, PARSE));
-				ok = (this->*parse_func)(r);
-				states.pop_back();
-			}
-			break;
+		el.push_back(_syntax_Error(con));
+		return false;
 	}
 
-	// If we successfully parsed the input, then cache the result.
-	if (ok)
+	//parse whitespace at the end
+	con.parse_term(con.whitespace_rule);
+
+	//if end is not reached, there was an error.  The end of a stream isn't
+	//known in advance, so ask the input rather than comparing with `finish`.
+	if (!con.end())
 	{
-		// To prevent the cache growing too large, if it starts to get quite
-		// big, delete everything.  256is a mostly arbitrary number generated
-		// by running a big(ish) parse with a few different values and finding
-		// the place where the increase in memory didn't come with a noticeable
-		// speedup.
-		if (cache.size() > 256)
+		if (!con.input.atEnd(con.error_pos.it.index()))
 		{
-			cache.clear();
+			el.push_back(_syntax_Error(con));
 		}
-		// Insert the new cache entry
-		auto &new_cache = cache[k];
-		new_cache.first = position;
-		auto &cached_matches = new_cache.second;
-		cached_matches.clear();
-		// If there some rules were matched, record them
-		if (matches.size() > new_match_index)
+		else
 		{
-			const auto index =
-				static_cast<Input::iterator::difference_type>(new_match_index);
-			cached_matches.insert(cached_matches.begin(), matches.begin() +
-					index, matches.end());
+			el.push_back(_eof_Error(con));
 		}
+		return false;
 	}
 
-	return ok;
-}
+	con.clear_cache();
 
+	//success; execute the parse procedures
+	con.do_parse_procs(d);
+	return true;
+}
 
+bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+           const ParserDelegate &delegate, void *d)
+{
+	ParseStatistics statistics;
+	return parse(i, g, ws, el, delegate, d, statistics);
+}
 
-//parse term rule.
-bool Context::parse_term(const Rule &r) 
+bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+           const ParserDelegate &delegate, void *d,
+           ParseStatistics &statistics)
 {
-	return parse_rule(r, &Context::_parse_term);
+	return parse(i, g, ws, el, delegate, d, ParseOptions(), statistics);
 }
-const bool debug_parsing = false;
 
+namespace {
+/**
+ * The sessions that are available for reuse by `parse()` on this thread.  A
+ * parse procedure may itself start a parse, so this holds as many sessions as
+ * the deepest nesting of parses so far.
+ */
+thread_local std::vector<std::unique_ptr<ParseSession>> idle_sessions;
+}
 
-//parse non-term rule internal.
-bool Context::_parse_non_term(const Rule &r)
+bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+           const ParserDelegate &delegate, void *d,
+           const ParseOptions &options, ParseStatistics &statistics)
 {
-	bool ok;
-	if (get_parse_proc(r))
+	std::unique_ptr<ParseSession> session;
+	if (idle_sessions.empty())
 	{
-		ParserPosition b = position;
-		ok = r.expr->parse_non_term(*this);
-		if (debug_parsing)
-		{
-			r.expr->dump();
-			fprintf(stderr, "\n");
-		}
-		if (ok)
-		{
-			matches.push_back(ParseMatch(std::addressof(r), b, position));
-		}
+		session.reset(new ParseSession());
 	}
 	else
 	{
-		ok = r.expr->parse_non_term(*this);
+		session = std::move(idle_sessions.back());
+		idle_sessions.pop_back();
 	}
+	bool ok = session->parse(i, g, ws, el, delegate, d, options, statistics);
+	idle_sessions.push_back(std::move(session));
 	return ok;
 }
 
+ParseSession::ParseSession() : storage(new Storage()) {}
 
-//parse term rule internal.
-bool Context::_parse_term(const Rule &r)
+ParseSession::~ParseSession() {}
+
+bool ParseSession::parse(Input &i, const Rule &g, const Rule &ws,
+                         ErrorList &el, const ParserDelegate &delegate,
+                         void *d)
 {
-	bool ok;
-	if (get_parse_proc(r))
+	ParseStatistics statistics;
+	return parse(i, g, ws, el, delegate, d, ParseOptions(), statistics);
+}
+
+bool ParseSession::parse(Input &i, const Rule &g, const Rule &ws,
+                         ErrorList &el, const ParserDelegate &delegate,
+                         void *d, const ParseOptions &options,
+                         ParseStatistics &statistics)
+{
+	// When parsing with an arena, the tables for this parse are allocated
+	// from it and the session's own storage is left alone.
+	if (options.arena)
 	{
-		ParserPosition b = position;
-		ok = r.expr->parse_term(*this);
-		if (ok)
+		Storage arena_storage(options.arena);
+		Context con(i, g, ws, delegate, options, arena_storage);
+		bool ok = parseGrammar(con, g, el, d);
+		if (options.memo_warm_up)
 		{
-			matches.push_back(ParseMatch(std::addressof(r), b, position));
+			con.choose_memo_policies();
 		}
+		statistics = con.statistics;
+		return ok;
 	}
-	else
+	reset();
+	//prepare context
+	Context con(i, g, ws, delegate, options, *storage);
+	bool ok = parseGrammar(con, g, el, d);
+	if (options.memo_warm_up)
 	{
-		ok = r.expr->parse_term(*this);
+		con.choose_memo_policies();
 	}
+	statistics = con.statistics;
 	return ok;
 }
 
-
-//get the next position
-static ParserPosition _next_pos(const ParserPosition &p)
+void ParseSession::reset()
 {
-	ParserPosition r = p;
-	++r.it;
-	++r.col;
-	return r;
+	storage->reset();
 }
 
+ParserDelegate::~ParserDelegate() {}
 
-//get syntax error
-static Error _syntax_Error(Context &con)
+/**
+ * The size of the header at the start of each arena chunk, rounded up so
+ * that the memory after it is suitably aligned for any type.
+ */
+static const size_t arena_header_size =
+	(sizeof(void*) * 2 + alignof(std::max_align_t) - 1) &
+	~(alignof(std::max_align_t) - 1);
+
+Arena::Arena(size_t size) :
+	chunk_size(std::max(size, arena_header_size * 16))
 {
-	std::string str = "syntax error: ";
-	str += static_cast<char>(*con.error_pos.it);
-	return Error(con.error_pos, _next_pos(con.error_pos), ERROR_SYNTAX_ERROR);
+	static_assert(sizeof(Chunk) <= arena_header_size,
+	              "Arena chunk header is too large");
 }
 
-
-//get eof error
-static Error _eof_Error(Context &con)
+Arena::~Arena()
 {
-	return Error(con.error_pos, con.error_pos, ERROR_INVALID_EOF);
+	release();
 }
 
-char32_t Input::slowCharacterLookup(Index n)
+void *Arena::allocateSlow(size_t size)
 {
-	const int back_seek = static_buffer_size / 4;
-	if (n >= size())
-	{
-		return 0;
-	}
-	// Optimise backtracking by jumping back 64 characters so subsequent
-	// forward scans are fast.
-	if (n < buffer_start)
-	{
-		buffer_start = (n > back_seek) ? n - back_seek : 0;
-	}
-	else
-	{
-		buffer_start = n;
-	}
-	Index length = static_buffer_size;
-	buffer = local_buffer;
-	if (!fillBuffer(buffer_start, length, buffer))
+	// Large allocations get a chunk of their own, so that the rest of the
+	// current chunk isn't wasted.
+	bool large = size > chunk_size / 4;
+	size_t bytes = large ? arena_header_size + size : chunk_size;
+	Chunk *c = static_cast<Chunk*>(::operator new(bytes));
+	c->size = bytes;
+	reserved += bytes;
+	used += size;
+	char *data = reinterpret_cast<char*>(c) + arena_header_size;
+	if (large)
 	{
-		buffer_end = 0;
-		return 0;
+		c->previous = full;
+		full = c;
+		return data;
 	}
-	buffer_end = buffer_start + length;
-	assert((n >= buffer_start) && (n < buffer_end));
-	return buffer[n - buffer_start];
-}
-Input::~Input() {}
-bool  UnicodeVectorInput::fillBuffer(Index start, Index &length, char32_t *&b)
-{
-	if (start > vector.size())
+	if (current)
 	{
-		return false;
+		current->previous = full;
+		full = current;
 	}
-	length = vector.size() - start;
-	// The buffer can't be const because this function is allowed to write into
-	// it, but the caller guarantees that it will not write to the returned
-	// value.
-	// We should probably clean up this interface to a const char32_t* instead
-	// of a bool...
-	b = const_cast<char32_t*>(vector.data() + start);
-	return true;
-}
-Input::Index UnicodeVectorInput::size() const
-{
-	return vector.size();
+	c->previous = nullptr;
+	current = c;
+	next = data + size;
+	end = reinterpret_cast<char*>(c) + bytes;
+	return data;
 }
 
-bool  StringInput::fillBuffer(Index start, Index &length, char32_t *&b)
+void Arena::reset()
 {
-	if (start > str.size())
+	// If the arena outgrew its current chunk, replace all of its chunks with
+	// one that is as large as all of them, so that allocating as much again
+	// doesn't need the heap.
+	if (full)
 	{
-		return false;
+		size_t bytes = reserved;
+		release();
+		Chunk *c = static_cast<Chunk*>(::operator new(bytes));
+		c->size = bytes;
+		c->previous = nullptr;
+		current = c;
+		end = reinterpret_cast<char*>(c) + bytes;
+		reserved = bytes;
 	}
-	length = std::min(length, str.size() - start);
-	for (Index i=start ; i<length ; i++)
+	used = 0;
+	if (current)
 	{
-		b[i] = static_cast<char32_t>(str[i]);
+		next = reinterpret_cast<char*>(current) + arena_header_size;
 	}
-	return true;
-}
-Input::Index StringInput::size() const
-{
-	return str.size();
 }
 
-AsciiFileInput::AsciiFileInput(int file) : fd(file)
+void Arena::release()
 {
-	struct stat buf;
-	if (fstat(fd, &buf) != 0)
-	{
-		file_size = 0;
-		perror("Input error");
-	}
-	else
+	while (full)
 	{
-		file_size = static_cast<Index>(buf.st_size);
+		Chunk *c = full;
+		full = c->previous;
+		::operator delete(c);
 	}
+	::operator delete(current);
+	current = nullptr;
+	next = end = nullptr;
+	used = 0;
+	reserved = 0;
 }
 
-const std::size_t Input::static_buffer_size;
-bool AsciiFileInput::fillBuffer(Index start, Index &length, char32_t *&b)
+static inline bool parseCharacter(Context &con, char32_t character)
 {
-	if (start > file_size)
-	{
-		return false;
-	}
-	char buffer[static_buffer_size];
-	// This should be a no-op
-	length = std::min(length, static_buffer_size);
-	length = std::min(length, file_size - start);
-	pread(fd, buffer, length, static_cast<off_t>(start));
-	for (Index i=0 ; i<length ; i++)
+	char32_t ch;
+	if (con.peek(ch))
 	{
-		b[i] = static_cast<char32_t>(buffer[i]);
+		if (ch == character)
+		{
+			con.next_col();
+			return true;
+		}
 	}
-	return true;
-}
-Input::Index AsciiFileInput::size() const
-{
-	return file_size;
-}
-
-/** constructor from input.
-	@param i input.
- */
-ParserPosition::ParserPosition(Input &i) :
-	it(i.begin()),
-	line(1),
-	col(1)
-{
+	con.set_error_pos();
+	return false;
 }
-
-/** creates a zero-or-more loop out of this expression.
-	@return a zero-or-more loop expression.
- */
-ExprPtr operator *(const ExprPtr &e)
+bool CharacterExpr::parse_non_term(Context &con) const
 {
-	return ExprPtr(new Loop0Expr(e));
+	return parseCharacter(con, character);
 }
 
-
-/** creates a one-or-more loop out of this expression.
-	@return a one-or-more loop expression.
- */
-ExprPtr operator +(const ExprPtr &e)
+bool CharacterExpr::parse_term(Context &con) const
 {
-	return ExprPtr(new Loop1Expr(e));
+	return parseCharacter(con, character);
 }
-
-
-/** creates an optional out of e expression.
-	@return an optional expression.
- */
-ExprPtr operator -(const ExprPtr &e)
+void CharacterExpr::compile(ProgramBuilder &b, bool term) const
 {
-	return ExprPtr(new OptionalExpr(e));
+	b.character(character, term);
 }
 
-
-/** creates an AND-expression.
-	@return an AND-expression.
- */
-ExprPtr operator &(const ExprPtr &e)
+void CharacterExpr::first(FirstSet &set, bool) const
 {
-	return ExprPtr(new AndExpr(e));
+	set.add(character);
 }
 
+// The interpreter dispatches with computed gotos where the compiler supports
+// them, as a separate indirect branch after each instruction predicts much
+// better than the single one at the top of a switch.
+#if defined(__GNUC__) && !defined(PEGMATITE_NO_COMPUTED_GOTO)
+#define VM_CASE(op) label_##op
+#define VM_DISPATCH() goto *dispatch_table[ip->op]
+#else
+#define VM_CASE(op) case op
+#define VM_DISPATCH() goto dispatch
+#endif
+#define VM_NEXT() do { ip++; VM_DISPATCH(); } while (0)
 
-/** creates a NOT-expression.
-	@return a NOT-expression.
- */
-ExprPtr operator !(const ExprPtr &e)
+bool Context::run(const Program &p)
 {
-	return ExprPtr(new NotExpr(e));
+	const Instruction *code = p.code.data();
+	const Instruction *ip = code;
+	size_t base = vm_frames.size();
+#if defined(__GNUC__) && !defined(PEGMATITE_NO_COMPUTED_GOTO)
+	static void *const dispatch_table[] =
+	{
+		&&label_OP_CHAR,
+		&&label_OP_ANY,
+		&&label_OP_SET,
+		&&label_OP_SPAN,
+		&&label_OP_STRING,
+		&&label_OP_EXPR_TERM,
+		&&label_OP_EXPR_NON_TERM,
+		&&label_OP_RULE_TERM,
+		&&label_OP_RULE_NON_TERM,
+		&&label_OP_WS,
+		&&label_OP_NEWLINE,
+		&&label_OP_CHOICE,
+		&&label_OP_DISPATCH,
+		&&label_OP_AND,
+		&&label_OP_NOT,
+		&&label_OP_COMMIT,
+		&&label_OP_AND_END,
+		&&label_OP_NOT_END,
+		&&label_OP_RETURN
+	};
+	VM_DISPATCH();
+#else
+dispatch:
+	switch (ip->op)
+	{
+#endif
+	VM_CASE(OP_CHAR):
+		if (!parseCharacter(*this, static_cast<char32_t>(ip->arg)))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_ANY):
+		if (end())
+		{
+			set_error_pos();
+			goto fail;
+		}
+		next_col();
+		VM_NEXT();
+	VM_CASE(OP_SET):
+		if (!static_cast<const SetExpr*>(ip->expr)->_parse(*this))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_SPAN):
+		while (static_cast<const SetExpr*>(ip->expr)->_parse(*this)) {}
+		VM_NEXT();
+	VM_CASE(OP_STRING):
+		if (!parseString(*this,
+		                 static_cast<const StringExpr*>(ip->expr)->chars()))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_EXPR_TERM):
+		if (!ip->expr->parse_term(*this))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_EXPR_NON_TERM):
+		if (!ip->expr->parse_non_term(*this))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_RULE_TERM):
+		if (!parse_term(*ip->rule))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_RULE_NON_TERM):
+		if (!parse_non_term(*ip->rule))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_WS):
+		parse_ws();
+		VM_NEXT();
+	VM_CASE(OP_NEWLINE):
+		next_line();
+		VM_NEXT();
+	VM_CASE(OP_CHOICE):
+	VM_CASE(OP_AND):
+	VM_CASE(OP_NOT):
+		push_frame(ip->op, ip->arg);
+		VM_NEXT();
+	VM_CASE(OP_DISPATCH):
+	{
+		const Dispatch &d = *ip->dispatch;
+		uint32_t alt = select(d, ip->arg);
+		if (alt == d.entries.size())
+		{
+			goto fail;
+		}
+		ip = code + d.entries[alt];
+		VM_DISPATCH();
+	}
+	VM_CASE(OP_COMMIT):
+		pop_frame();
+		ip = code + ip->arg;
+		VM_DISPATCH();
+	VM_CASE(OP_AND_END):
+		if (!restore(pop_frame()))
+		{
+			goto fail;
+		}
+		VM_NEXT();
+	VM_CASE(OP_NOT_END):
+		restore(pop_frame());
+		goto fail;
+	VM_CASE(OP_RETURN):
+		return true;
+#if !defined(__GNUC__) || defined(PEGMATITE_NO_COMPUTED_GOTO)
+	}
+#endif
+fail:
+	uint32_t alt;
+	if (backtrack(base, alt))
+	{
+		ip = code + alt;
+		VM_DISPATCH();
+	}
+	return false;
 }
+#undef VM_CASE
+#undef VM_DISPATCH
+#undef VM_NEXT
 
-
-/** constructor.
-	@param b begin position.
-	@param e end position.
- */
-InputRange::InputRange(const ParserPosition &b, const ParserPosition &e) : start(b), finish(e) { }
-
-std::string InputRange::str() const
+bool GeneratedContext::install(const Rule &r, GeneratedRule non_term,
+                               uint64_t non_term_fingerprint,
+                               GeneratedRule term, uint64_t term_fingerprint)
 {
-	std::stringstream s;
-
-	for (char c : *this)
+	if ((r.program(false).fingerprint != non_term_fingerprint) ||
+	    (r.program(true).fingerprint != term_fingerprint))
 	{
-		s << c;
+		return false;
 	}
-
-	return s.str();
+	r.generated[0] = non_term;
+	r.generated[1] = term;
+	return true;
 }
 
-
-/** constructor.
-	@param b begin position.
-	@param e end position.
-	@param t error type.
- */
-Error::Error(const ParserPosition &b, const ParserPosition &e, int t) :
-	InputRange(b, e), error_type(t) { }
-
-
-/** compare on begin position.
-	@param e the other error to compare this with.
-	@return true if this comes before the previous error, false otherwise.
- */
-bool Error::operator < (const Error &e) const
+bool GeneratedContext::peekSlow(char32_t &c)
 {
-	return start.it < e.start.it;
+	return context.peek(c);
 }
 
-Rule::Rule(const ExprPtr e) :
-	expr(e)
+void GeneratedContext::pin()
 {
+	context.pin(cursor.position.it.index());
 }
 
-
-/** constructor from rule.
-	@param r rule.
- */
-ExprPtr::ExprPtr(const char *s) : std::shared_ptr<Expr>(new StringExpr(s)) {}
-ExprPtr::ExprPtr(const char32_t s) : std::shared_ptr<Expr>(new CharacterExpr(s)) {}
-ExprPtr::ExprPtr(const Rule &r) : std::shared_ptr<Expr>(new RuleReferenceExpr(r)) {}
-
-
-/** creates a sequence of expressions.
-	@param left left operand.
-	@param right right operand.
-	@return an expression which parses a sequence.
- */
-ExprPtr operator >> (const ExprPtr &left, const ExprPtr &right)
+void GeneratedContext::unpin()
 {
-	return ExprPtr(new SequenceExpr(left, right));
+	context.unpin();
 }
 
-
-/** creates a choice of expressions.
-	@param left left operand.
-	@param right right operand.
-	@return an expression which parses a choice.
- */
-ExprPtr operator | (const ExprPtr &left, const ExprPtr &right)
+bool GeneratedContext::any()
 {
-	return ExprPtr(new ChoiceExpr(left, right));
+	if (context.end())
+	{
+		context.set_error_pos();
+		return false;
+	}
+	context.next_col();
+	return true;
 }
 
-
-/** converts a parser expression into a terminal.
-	@param e expression.
-	@return an expression which parses a terminal.
- */
-ExprPtr term(const ExprPtr &e)
+void GeneratedContext::whitespace()
 {
-	return ExprPtr(new TerminalExpr(e));
+	context.parse_ws();
 }
 
-
-/** creates a set expression from a null-terminated string.
-	@param s null-terminated string with characters of the set.
-	@return an expression which parses a single character out of a set.
- */
-ExprPtr set(const char *s)
+void GeneratedContext::newline()
 {
-	return ExprPtr(new SetExpr(s));
+	context.next_line();
 }
 
-/**
- * Creates a regex expression from the specified string.
- */
-ExprPtr regex(const char *s)
+bool GeneratedContext::call(uint32_t i)
 {
-	return ExprPtr(new RegexExpr<char>(s));
+	assert(program && "No bytecode to call into");
+	const Instruction &in = program->code[i];
+	switch (in.op)
+	{
+	case OP_STRING:
+	case OP_EXPR_TERM:
+		return in.expr->parse_term(context);
+	case OP_EXPR_NON_TERM:
+		return in.expr->parse_non_term(context);
+	case OP_RULE_TERM:
+		return context.parse_term(*in.rule);
+	case OP_RULE_NON_TERM:
+		return context.parse_non_term(*in.rule);
+	default:
+		assert(0 && "Instruction is not a call");
+		return false;
+	}
 }
 
-/**
- * Creates a regex expression from the specified wide string.
- */
-ExprPtr regex(const wchar_t *s)
-{
-	return ExprPtr(new RegexExpr<wchar_t>(s));
-}
-ExprPtr operator "" _R(const char *x, std::size_t len)
+uint32_t GeneratedContext::dispatch(uint32_t i)
 {
-	return ExprPtr(new RegexExpr<char>(x, len));
+	assert(program && "No bytecode to dispatch with");
+	const Instruction &in = program->code[i];
+	assert((in.op == OP_DISPATCH) && "Instruction is not a dispatch");
+	uint32_t alt = context.select(*in.dispatch, in.arg);
+	return (alt < in.dispatch->entries.size()) ? alt : UINT32_MAX;
 }
 
-
-/** creates a range expression.
-	@param min min character.
-	@param max max character.
-	@return an expression which parses a single character out of range.
- */
-ExprPtr range(char32_t min, char32_t max)
+bool GeneratedContext::rule(const Rule &r, bool term)
 {
-	return ExprPtr(new SetExpr(min, max));
+	return term ? context.parse_term(r) : context.parse_non_term(r);
 }
 
-
-/** creates an expression which increments the line counter
-	and resets the column counter when the given expression
-	is parsed successfully; used for newline characters.
-	@param e expression to wrap into a newline parser.
-	@return an expression that handles newlines.
- */
-ExprPtr nl(const ExprPtr &e)
+bool GeneratedContext::expression(const Expr &e, bool term)
 {
-	return ExprPtr(new NewlineExpr(e));
+	return term ? e.parse_term(context) : e.parse_non_term(context);
 }
 
-
-/** creates an expression which tests for the end of input.
-	@return an expression that handles the end of input.
- */
-ExprPtr eof()
+bool GeneratedExpr::parse_non_term(Context &con) const
 {
-	return ExprPtr(new EndOfFileExpr());
+	GeneratedContext c(con, con, nullptr);
+	return match(c, false);
 }
 
-
-
-/** creates an expression that parses any character.
-	@return the appropriate expression.
- */
-ExprPtr any()
+bool GeneratedExpr::parse_term(Context &con) const
 {
-	return ExprPtr(new AnyExpr());
+	GeneratedContext c(con, con, nullptr);
+	return match(c, true);
 }
 
-ExprPtr debug(std::function<void()> fn)
-{
-	return ExprPtr(new DebugExpr(fn));
-}
-#ifdef DEBUG_PARSING
-ExprPtr trace_debug(const char *msg, const ExprPtr e)
+/**
+ * Writes an expression that is true if `ch` is in `set`.
+ */
+static void writeSetCondition(FILE *out, const SetExpr &set)
 {
-	return ExprPtr(new TraceExpr(msg, e));
+	const char *separator = "";
+	char32_t limit = set.limit();
+	for (char32_t c = 0; c < limit; c++)
+	{
+		if (!set.contains(c))
+		{
+			continue;
+		}
+		char32_t last = c;
+		while ((last + 1 < limit) && set.contains(last + 1))
+		{
+			last++;
+		}
+		if (last == c)
+		{
+			fprintf(out, "%s(ch == 0x%x)", separator, static_cast<unsigned>(c));
+		}
+		else
+		{
+			fprintf(out, "%s((ch >= 0x%x) && (ch <= 0x%x))", separator,
+			        static_cast<unsigned>(c), static_cast<unsigned>(last));
+		}
+		separator = " || ";
+		c = last;
+	}
+	if (!*separator)
+	{
+		fprintf(out, "false");
+	}
 }
-#endif
 
-
-/** parses the given input.
-	The parse procedures of each rule parsed are executed
-	before this function returns, if parsing succeeds.
-	@param i input.
-	@param g root rule of grammar.
-	@param ws whitespace rule.
-	@param el list of errors.
-	@param d user data, passed to the parse procedures.
-	@return true on parsing success, false on failure.
+/**
+ * Writes a function called `name` that does the same as the bytecode `p`.
+ * Each instruction becomes a statement, and jumps become gotos.  The compiler
+ * emits backtrack points in nested pairs, so the points that are live at each
+ * instruction are known here.  Each is kept in a local `Mark` and a failure
+ * jumps straight to the code that restores the innermost one.
  */
-bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
-           const ParserDelegate &delegate, void *d)
+static void writeProgram(FILE *out, const Program &p, const char *name)
 {
-	//prepare context
-	Context con(i, ws, delegate);
-
-	//parse initial whitespace
-	con.parse_term(con.whitespace_rule);
-
-	//parse grammar
-	if (!con.parse_non_term(g))
+	const std::vector<Instruction> &code = p.code;
+	const uint32_t none = UINT32_MAX;
+	// For each instruction, the instruction that saved the innermost live
+	// backtrack point and the number of live points, before it runs.
+	std::vector<uint32_t> inner(code.size(), none);
+	std::vector<uint32_t> depth(code.size(), 0);
+	// For each instruction that saves a backtrack point, the one that saved
+	// the point enclosing it.
+	std::vector<uint32_t> outer(code.size(), none);
+	std::vector<bool> handled(code.size());
+	std::vector<bool> targets(code.size());
+	std::vector<uint32_t> stack;
+	uint32_t max_depth = 0;
+	auto fails_to = [&](uint32_t frame)
+		{
+			if (frame != none)
+			{
+				handled[frame] = true;
+			}
+		};
+	for (uint32_t idx = 0; idx < code.size(); idx++)
 	{
-		el.push_back(_syntax_Error(con));
-		return false;
+		const Instruction &i = code[idx];
+		inner[idx] = stack.empty() ? none : stack.back();
+		depth[idx] = static_cast<uint32_t>(stack.size());
+		switch (i.op)
+		{
+		case OP_CHOICE:
+		case OP_AND:
+		case OP_NOT:
+			outer[idx] = inner[idx];
+			stack.push_back(idx);
+			max_depth = std::max(max_depth, static_cast<uint32_t>(stack.size()));
+			break;
+		case OP_COMMIT:
+			targets[i.arg] = true;
+			stack.pop_back();
+			break;
+		case OP_DISPATCH:
+			for (uint32_t alt = i.arg; alt < i.dispatch->entries.size(); alt++)
+			{
+				targets[i.dispatch->entries[alt]] = true;
+			}
+			fails_to(inner[idx]);
+			break;
+		case OP_AND_END:
+		case OP_NOT_END:
+			stack.pop_back();
+			fails_to(stack.empty() ? none : stack.back());
+			break;
+		case OP_CHAR:
+		case OP_ANY:
+		case OP_SET:
+		case OP_STRING:
+		case OP_EXPR_TERM:
+		case OP_EXPR_NON_TERM:
+		case OP_RULE_TERM:
+		case OP_RULE_NON_TERM:
+			fails_to(inner[idx]);
+			break;
+		default:
+			break;
+		}
 	}
-
-	//parse whitespace at the end
-	con.parse_term(con.whitespace_rule);
-
-	//if end is not reached, there was an error
-	if (!con.end())
+	// A handler that can't restore its point, because of a cut, fails to the
+	// enclosing one.  Enclosing points are saved first, so walking backwards
+	// finds every handler that is used.
+	for (uint32_t idx = static_cast<uint32_t>(code.size()); idx-- > 0;)
 	{
-		if (con.error_pos.it < con.finish)
+		if (handled[idx])
 		{
-			el.push_back(_syntax_Error(con));
+			fails_to(outer[idx]);
+			if (code[idx].op != OP_AND)
+			{
+				targets[code[idx].arg] = true;
+			}
+		}
+	}
+	auto fail = [&](uint32_t frame)
+		{
+			if (frame == none)
+			{
+				fprintf(out, "return false;");
+			}
+			else
+			{
+				fprintf(out, "goto f%u;", frame);
+			}
+		};
+	fprintf(out, "static bool %s(GeneratedContext &c)\n{\n", name);
+	for (uint32_t d = 0; d < max_depth; d++)
+	{
+		fprintf(out, "\tGeneratedContext::Mark m%u;\n", d);
+	}
+	for (uint32_t idx = 0; idx < code.size(); idx++)
+	{
+		const Instruction &i = code[idx];
+		if (targets[idx])
+		{
+			fprintf(out, "l%u:\n", idx);
+		}
+		uint32_t d = depth[idx];
+		switch (i.op)
+		{
+		case OP_CHAR:
+			fprintf(out, "\tif (!c.character(0x%x))\n\t{\n\t\t", i.arg);
+			fail(inner[idx]);
+			fprintf(out, "\n\t}\n");
+			break;
+		case OP_ANY:
+			fprintf(out, "\tif (!c.any())\n\t{\n\t\t");
+			fail(inner[idx]);
+			fprintf(out, "\n\t}\n");
+			break;
+		case OP_SET:
+			fprintf(out, "\t{\n\t\tchar32_t ch;\n\t\tif (!c.peek(ch) || !(");
+			writeSetCondition(out, *static_cast<const SetExpr*>(i.expr));
+			fprintf(out, "))\n\t\t{\n\t\t\tc.mismatch();\n\t\t\t");
+			fail(inner[idx]);
+			fprintf(out, "\n\t\t}\n\t\tc.advance();\n\t}\n");
+			break;
+		case OP_SPAN:
+			fprintf(out, "\tfor (char32_t ch; c.peek(ch) && (");
+			writeSetCondition(out, *static_cast<const SetExpr*>(i.expr));
+			fprintf(out, ");)\n\t{\n\t\tc.advance();\n\t}\n\tc.mismatch();\n");
+			break;
+		case OP_STRING:
+		{
+			// Like the interpreter, this leaves the position after the
+			// characters that matched.
+			const std::vector<char32_t> &chars =
+				static_cast<const StringExpr*>(i.expr)->chars();
+			if (chars.empty())
+			{
+				break;
+			}
+			const char *separator = "";
+			fprintf(out, "\tif (");
+			for (char32_t ch : chars)
+			{
+				fprintf(out, "%s!c.character(0x%x)", separator,
+				        static_cast<uint32_t>(ch));
+				separator = " ||\n\t    ";
+			}
+			fprintf(out, ")\n\t{\n\t\t");
+			fail(inner[idx]);
+			fprintf(out, "\n\t}\n");
+			break;
+		}
+		case OP_EXPR_TERM:
+		case OP_EXPR_NON_TERM:
+		case OP_RULE_TERM:
+		case OP_RULE_NON_TERM:
+			fprintf(out, "\tif (!c.call(%u))\n\t{\n\t\t", idx);
+			fail(inner[idx]);
+			fprintf(out, "\n\t}\n");
+			break;
+		case OP_WS:
+			fprintf(out, "\tc.whitespace();\n");
+			break;
+		case OP_NEWLINE:
+			fprintf(out, "\tc.newline();\n");
+			break;
+		case OP_CHOICE:
+		case OP_AND:
+		case OP_NOT:
+			fprintf(out, "\tm%u = c.mark();\n", d);
+			break;
+		case OP_DISPATCH:
+		{
+			const std::vector<uint32_t> &entries = i.dispatch->entries;
+			fprintf(out, "\tswitch (c.dispatch(%u))\n\t{\n", idx);
+			for (uint32_t alt = i.arg; alt < entries.size(); alt++)
+			{
+				fprintf(out, "\tcase %u:\n\t\tgoto l%u;\n", alt, entries[alt]);
+			}
+			fprintf(out, "\tdefault:\n\t\t");
+			fail(inner[idx]);
+			fprintf(out, "\n\t}\n");
+			break;
+		}
+		case OP_COMMIT:
+			fprintf(out, "\tc.release(m%u);\n\tgoto l%u;\n", d - 1, i.arg);
+			break;
+		case OP_AND_END:
+			fprintf(out, "\tif (!c.reset(m%u))\n\t{\n\t\t", d - 1);
+			fail(outer[inner[idx]]);
+			fprintf(out, "\n\t}\n");
+			break;
+		case OP_NOT_END:
+			fprintf(out, "\tc.reset(m%u);\n\t", d - 1);
+			fail(outer[inner[idx]]);
+			fprintf(out, "\n");
+			break;
+		case OP_RETURN:
+			fprintf(out, "\treturn true;\n");
+			break;
+		}
+	}
+	for (uint32_t idx = 0; idx < code.size(); idx++)
+	{
+		if (!handled[idx])
+		{
+			continue;
+		}
+		fprintf(out, "f%u:\n", idx);
+		if (code[idx].op == OP_AND)
+		{
+			fprintf(out, "\tc.reset(m%u);\n\t", depth[idx]);
 		}
 		else
 		{
-			el.push_back(_eof_Error(con));
+			fprintf(out, "\tif (c.reset(m%u))\n\t{\n\t\tgoto l%u;\n\t}\n\t",
+			        depth[idx], code[idx].arg);
 		}
-		return false;
+		fail(outer[idx]);
+		fprintf(out, "\n");
 	}
-
-	con.clear_cache();
-
-	//success; execute the parse procedures
-	con.do_parse_procs(d);
-	return true;
+	fprintf(out, "}\n\n");
 }
 
-ParserDelegate::~ParserDelegate() {}
-
-static inline bool parseCharacter(Context &con, char32_t character)
+bool generateParser(FILE *out, const GeneratorOptions &options,
+                    const std::vector<GeneratorRule> &rules)
 {
-	if (!con.end())
+	fprintf(out, "// Generated by pegmatite::generateParser().  Do not edit.\n"
+	             "#include \"%s\"\n\n"
+	             "using pegmatite::GeneratedContext;\n\n",
+	        options.header.c_str());
+	for (size_t i = 0; i < rules.size(); i++)
 	{
-		char32_t ch = con.symbol();
-		if (ch == character)
+		for (int term = 0; term < 2; term++)
 		{
-			con.next_col();
-			return true;
+			char name[64];
+			snprintf(name, sizeof(name), "rule_%zu_%s", i,
+			         term ? "term" : "non_term");
+			fprintf(out, "// %s, as a %s.\n", rules[i].name.c_str(),
+			        term ? "terminal" : "non-terminal");
+			writeProgram(out, rules[i].rule->program(term), name);
 		}
 	}
-	con.set_error_pos();
-	return false;
-}
-bool CharacterExpr::parse_non_term(Context &con) const
-{
-	return parseCharacter(con, character);
-}
-
-bool CharacterExpr::parse_term(Context &con) const
-{
-	return parseCharacter(con, character);
+	fprintf(out, "bool %s(const %s &g)\n{\n\tbool ok = true;\n",
+	        options.function.c_str(), options.grammar.c_str());
+	for (size_t i = 0; i < rules.size(); i++)
+	{
+		const Rule &r = *rules[i].rule;
+		fprintf(out, "\tok = GeneratedContext::install(g.%s,\n"
+		             "\t\trule_%zu_non_term, 0x%" PRIx64 "ULL,\n"
+		             "\t\trule_%zu_term, 0x%" PRIx64 "ULL) && ok;\n",
+		        rules[i].name.c_str(), i, r.program(false).fingerprint, i,
+		        r.program(true).fingerprint);
+	}
+	fprintf(out, "\treturn ok;\n}\n");
+	return (fflush(out) == 0) && !ferror(out);
 }
 void CharacterExpr::dump() const
 {
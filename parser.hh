@@ -28,21 +28,81 @@
 #define PEGMATITE_PARSER_HPP
 
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
 #include <vector>
 #include <string>
 #include <list>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <type_traits>
 
 
+struct iovec;
+
 namespace pegmatite {
 
 
 class Expr;
 class Context;
 class Rule;
+class InputRange;
+class Program;
+class ProgramBuilder;
+class FirstSet;
+class GrammarLayout;
+class GeneratedContext;
+struct GeneratorOptions;
+struct GeneratorRule;
+
+/**
+ * A function, emitted by `generateParser()`, that parses the expression of a
+ * rule.
+ */
+typedef bool (*GeneratedRule)(GeneratedContext &);
 
 
+/**
+ * Counters describing how well the character window of an `Input` is working.
+ * A window that is too small for the amount of backtracking that a grammar
+ * does will show a high proportion of backward misses.
+ */
+struct InputStatistics
+{
+	/**
+	 * The number of lookups satisfied from the current window.  Counting
+	 * these costs a write on every character lookup, so they are only counted
+	 * if `PEGMATITE_COUNT_INPUT_HITS` is defined, and are zero otherwise.
+	 * Lookups are inlined, so the macro must be defined both when building
+	 * the library and when compiling code that uses it.  The
+	 * `COUNT_INPUT_HITS` CMake option does this for targets that link with
+	 * the library.  The other counters are only updated when the window
+	 * misses, and are always maintained.
+	 */
+	uint64_t hits = 0;
+	/**
+	 * The number of lookups after the current window, which required the
+	 * window to be refilled.
+	 */
+	uint64_t forward_misses = 0;
+	/**
+	 * The number of lookups before the current window, which required the
+	 * window to be refilled.
+	 */
+	uint64_t backward_misses = 0;
+	/**
+	 * The number of characters copied into the window.  Inputs that expose
+	 * their own storage to the window do not copy, so do not contribute to
+	 * this.
+	 */
+	uint64_t characters_fetched = 0;
+};
+
 /**
  * Abstract superclass for indexing into a buffer with arbitrary storage.
  * The class holds a private buffer of characters and requests that the
@@ -53,10 +113,14 @@ class Input
 {
 	protected:
 	/**
-	 * Size for the static buffer.  Note that changing this will change the
-	 * ABI, so do not change it in shared library builds!
+	 * The default size of the window, in characters.  The window is allocated
+	 * on demand, so this is not part of the ABI.
 	 */
 	static const std::size_t static_buffer_size = 512;
+	/**
+	 * The default size that the window may grow to, in characters.
+	 */
+	static const std::size_t default_max_window_size = 16384;
 	public:
 	/**
 	 * The type of indexes into the buffer.
@@ -128,10 +192,30 @@ class Input
 		/**
 		 * Compares iterators for equality.  Iterators are equal if they are
 		 * the same index in the same buffer.
+		 *
+		 * The end iterator of an input whose size is not yet known has an
+		 * index of `npos` and compares equal to any iterator that refers to
+		 * the end of the input.
 		 */
 		inline bool operator==(const iterator &other) const
 		{
-			return (buffer == other.buffer) && (idx == other.idx);
+			if (buffer != other.buffer)
+			{
+				return false;
+			}
+			if (idx == other.idx)
+			{
+				return true;
+			}
+			if (other.idx == npos)
+			{
+				return buffer->atEnd(idx);
+			}
+			if (idx == npos)
+			{
+				return buffer->atEnd(other.idx);
+			}
+			return false;
 		}
 		/**
 		 * Compares iterators for inequality.
@@ -174,12 +258,35 @@ class Input
 		return iterator(this, 0);
 	}
 	/**
-	 * Returns an iterator for the end of the input.
+	 * Returns an iterator for the end of the input.  If the size of the input
+	 * is not yet known, then the returned iterator has an index of `npos` and
+	 * compares equal to any iterator that refers to the end of the input.
 	 */
 	inline iterator end()
 	{
 		return iterator(this, size());
 	}
+	/**
+	 * Returns true if `n` is at (or beyond) the end of the input.  For inputs
+	 * whose size is not known in advance, this may need to read more of the
+	 * input.
+	 */
+	inline bool atEnd(Index n)
+	{
+		Index s = size();
+		if (s != npos)
+		{
+			return n >= s;
+		}
+		return !available(n);
+	}
+	/**
+	 * Informs the input that the parser will never again access characters
+	 * before index `n`.  Inputs that buffer their data (such as
+	 * `StreamInput`) may discard it.  The default implementation does
+	 * nothing.
+	 */
+	virtual void release(Index n);
 	/**
 	 * Fetch the character at the specified index.  This is intended to be
 	 * inlined and returns the character from the cached buffer if possible,
@@ -190,16 +297,73 @@ class Input
 		// If the local buffer can satisfy the request, fetch the value
 		if ((n >= buffer_start) && (n < buffer_end))
 		{
+#ifdef PEGMATITE_COUNT_INPUT_HITS
+			stats.hits++;
+#endif
 			return buffer[n - buffer_start];
 		}
 		return slowCharacterLookup(n);
 	}
+	/**
+	 * Provides direct access to the underlying storage, for inputs that store
+	 * one character per byte.  If the input can do so, then it sets `data` to
+	 * point to the byte for the character at index `start` and returns true,
+	 * with `start` and `end` describing a contiguous run of the input that
+	 * contains the index `n`.  The parser reads from this run directly,
+	 * without copying it into a buffer of 32-bit characters.
+	 *
+	 * Inputs that do not store their data in this form return false for every
+	 * index and are accessed via `operator[]`.  The default implementation
+	 * always returns false.
+	 *
+	 * The returned pointer must remain valid until the next call to this
+	 * method, or until the input is destroyed.
+	 */
+	virtual bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end);
+	/**
+	 * Provides direct access to the underlying storage, for inputs that store
+	 * characters as contiguous 32-bit values.  This follows the same contract
+	 * as `byteSpan()`, and allows the parser to read characters without
+	 * checking the buffer on every access.  The default implementation
+	 * always returns false.
+	 */
+	virtual bool characterSpan(Index n, const char32_t *&data, Index &start, Index &end);
+	/**
+	 * Sets the size of the window of characters that is cached for inputs that
+	 * are accessed via `operator[]`.  If `max_size` is larger than `size` then
+	 * the window starts at `size` characters and is doubled, up to `max_size`,
+	 * whenever backtracking causes most of the misses.  This takes effect on
+	 * the next miss.
+	 */
+	void setWindowSize(Index size, Index max_size=0);
+	/**
+	 * Returns the current size of the window.
+	 */
+	Index windowSize() const { return window_size; }
+	/**
+	 * Returns the counters for accesses to the window.
+	 */
+	const InputStatistics &statistics() const { return stats; }
+	/**
+	 * Resets the counters for accesses to the window.
+	 */
+	void resetStatistics() { stats = InputStatistics(); }
 	/**
 	 * Default constructor, sets the buffer start to be after the buffer end,
 	 * so that the first request will trigger a fetch from the underlying
 	 * storage.
 	 */
-	Input() : buffer(0), buffer_start(1), buffer_end(0) {}
+	Input() : buffer(0), buffer_start(1), buffer_end(0), local_buffer_size(0),
+		window_size(static_buffer_size), max_window_size(default_max_window_size),
+		recent_forward_misses(0), recent_backward_misses(0) {}
+	/**
+	 * Copy constructor.  Copies the window configuration, but not the window
+	 * itself or the counters.
+	 */
+	Input(const Input &other) : buffer(0), buffer_start(1), buffer_end(0),
+		local_buffer_size(0), window_size(other.window_size),
+		max_window_size(other.max_window_size), recent_forward_misses(0),
+		recent_backward_misses(0) {}
 	private:
 	/**
 	 * A pointer to the start of the buffer.  This must be a contiguous block
@@ -216,9 +380,34 @@ class Input
 	Index	 buffer_end;
 	/**
 	 * A buffer that can be used to store characters by subclasses that do not
-	 * have the same underlying representation.
+	 * have the same underlying representation.  This is allocated on the first
+	 * miss, so inputs that are only accessed directly never allocate it.
+	 */
+	std::unique_ptr<char32_t[]> local_buffer;
+	/**
+	 * The number of characters allocated for `local_buffer`.
+	 */
+	Index	 local_buffer_size;
+	/**
+	 * The number of characters to request on each miss.
+	 */
+	Index	 window_size;
+	/**
+	 * The size that the window may grow to.
+	 */
+	Index	 max_window_size;
+	/**
+	 * Forward misses since the window size was last reconsidered.
+	 */
+	Index	 recent_forward_misses;
+	/**
+	 * Backward misses since the window size was last reconsidered.
+	 */
+	Index	 recent_backward_misses;
+	/**
+	 * Counters for accesses to the window.
 	 */
-	char32_t  local_buffer[static_buffer_size];
+	InputStatistics stats;
 	/**
 	 * Slow path, filling in the buffer from the data source if a request can't
 	 * be satisfied from the cache.
@@ -239,9 +428,16 @@ class Input
 	 */
 	virtual bool  fillBuffer(Index start, Index &length, char32_t *&b) = 0;
 	/**
-	 * Returns the size of the buffer.
+	 * Returns the size of the buffer, or `npos` if the size is not yet known.
 	 */
 	virtual Index size() const = 0;
+	/**
+	 * For inputs whose size is not known in advance, ensures that the
+	 * character at index `n` has been read, if it exists.  Returns true if
+	 * there is a character at index `n`.  The default implementation checks
+	 * the index against the size.
+	 */
+	virtual bool available(Index n);
 	/**
 	 * Virtual destructor.
 	 */
@@ -254,9 +450,9 @@ class Input
 class UnicodeVectorInput : public Input
 {
 	/**
-	 * A reference to the vector being used as input.
+	 * The vector being used as input.
 	 */
-	const std::vector<char32_t> vector;
+	std::vector<char32_t> vector;
 	public:
 	/**
 	 * Returns an immutable reference to the vector.  The returned value is
@@ -268,11 +464,15 @@ class UnicodeVectorInput : public Input
 	 * Constructs the wrapper from a vector.  
 	 * The new object takes ownership of the character data in the vector.
 	 */
-	UnicodeVectorInput(std::vector<char32_t> &&v) : vector(v) {}
+	UnicodeVectorInput(std::vector<char32_t> &&v) : vector(std::move(v)) {}
 	/**
 	 * Provides direct access to the underlying vector's storage.
 	 */
 	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the entire vector as a single run of characters.
+	 */
+	bool characterSpan(Index n, const char32_t *&data, Index &start, Index &end) override;
 	/**
 	 * Returns the size of the vector.
 	 */
@@ -304,6 +504,74 @@ struct AsciiFileInput : public Input
 	size_t file_size;
 };
 
+/**
+ * A concrete `Input` class that maps a file into memory, rather than reading
+ * it with a system call every time that the buffer is refilled.  As with
+ * `AsciiFileInput`, the file is assumed to be in ASCII.
+ *
+ * The file is mapped once, so backtracking never needs to go back to the file
+ * descriptor.  The kernel is advised that access will be mostly sequential and
+ * is asked to read ahead of the parser in blocks of `readahead_size` bytes.
+ * Pages that the parser has moved past can be reclaimed, so files larger than
+ * physical memory can be parsed.  If the file can not be mapped (for example,
+ * if the descriptor refers to something other than a regular file) then this
+ * falls back to reading the file in the same way as `AsciiFileInput`.
+ */
+class MmapFileInput : public Input
+{
+	public:
+	/**
+	 * The number of bytes that the kernel is asked to prefetch ahead of the
+	 * current parse position.
+	 */
+	static const std::size_t readahead_size = 1 << 20;
+	/**
+	 * Construct a parser input from a specified file descriptor.  The file
+	 * descriptor is not closed when this object is destroyed, but must remain
+	 * valid for as long as this object exists.
+	 */
+	MmapFileInput(int file);
+	/**
+	 * Unmaps the file.
+	 */
+	~MmapFileInput();
+	/**
+	 * Copying would result in the mapping being unmapped twice.
+	 */
+	MmapFileInput(const MmapFileInput&) = delete;
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the mapping as runs of bytes of `readahead_size`, if the file
+	 * was successfully mapped.  Each call asks the kernel to prefetch the
+	 * run after the one returned.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	Index size() const override;
+	private:
+	/**
+	 * Asks the kernel to prefetch the mapping up to index `end`, one block of
+	 * `readahead_size` bytes at a time, starting no earlier than the block
+	 * containing `start`.
+	 */
+	void advise(Index start, Index end);
+	/**
+	 * The file descriptor for the file that this encapsulates.
+	 */
+	int fd;
+	/**
+	 * The size of the file.
+	 */
+	size_t file_size;
+	/**
+	 * The start of the mapping, or null if the file could not be mapped.
+	 */
+	const unsigned char *data;
+	/**
+	 * The end of the range that the kernel has been asked to prefetch.
+	 */
+	size_t advised_end;
+};
+
 /**
  * A concrete Input subclass that wraps a std::string, providing access to the
  * underlying characters.
@@ -313,7 +581,7 @@ class StringInput : public Input
 	/**
 	 * The string representing the underlying data.
 	 */
-	const std::string str;
+	std::string str;
 	public:
 	/**
 	 * Returns an immutable reference to the vector.  The returned value is
@@ -325,7 +593,7 @@ class StringInput : public Input
 	 * Constructs the wrapper from a string (`s`).  
 	 * The new object takes ownership of the character data in the string.
 	 */
-	StringInput(std::string &&s) : str(s) {}
+	StringInput(std::string &&s) : str(std::move(s)) {}
 	/**
 	 * Constructs the wrapper from a string (`s`).
 	 * The new object is copy-constructed from the string argument.
@@ -335,199 +603,762 @@ class StringInput : public Input
 	 * Provides direct access to the underlying string's storage.
 	 */
 	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the entire string as a single run of bytes.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
 	/**
 	 * Returns the size of the string.
 	 */
 	Index size() const override;
 };
 
-template<class T>
-class IteratorInput : public Input
+/**
+ * A concrete Input subclass that refers to a range of characters owned by the
+ * caller, without copying them.  The caller is responsible for ensuring that
+ * the characters remain valid and unmodified for as long as this object (and
+ * any `InputRange` referring to it) exists.
+ */
+class StringViewInput : public Input
 {
 	/**
-	 * The iterator for the start of the input.
+	 * The start of the underlying data.
 	 */
-	T begin;
+	const char *str;
 	/**
-	 * The iterator for the end of the input.
+	 * The number of characters in the underlying data.
 	 */
-	T end;
+	Index length;
 	public:
 	/**
-	 * Construct an input that reads from between the two iterators specified.
+	 * Constructs the wrapper from `l` characters starting at `s`.
 	 */
-	IteratorInput(T b, T e) : begin(b), end(e) {}
+	StringViewInput(const char *s, Index l) : str(s), length(l) {}
 	/**
-	 * Copy the data into the buffer.
+	 * Constructs the wrapper from a string.  The string is not copied and
+	 * must outlive this object.
 	 */
-	bool fillBuffer(Index start, Index &length, char32_t *&b) override
-	{
-		if (start > std::distance(begin, end))
-		{
-			length = 0;
-			return false;
-		}
-		Index copied = 0;
-		for (T i=std::advance(begin, start) ; (i != end) && (copied < length) ; ++i)
-		{
-			b[copied++] = static_cast<char32_t>(*i);
-		}
-		length = copied;
-		return true;
-	}
+	StringViewInput(const std::string &s) : str(s.data()), length(s.size()) {}
 	/**
-	 * Returns the size of the string.
+	 * Prevent accidentally referring to a temporary string.
 	 */
-	Index size() const override { return std::distance(begin, end); }
-};
-
-
-///position into the input.
-struct ParserPosition
-{
-	///iterator into the input.
-	Input::iterator it;
-
-	///line.
-	int line;
-
-	///column.
-	int col;
-
-	///null constructor.
-	ParserPosition() {}
-
-	/** constructor from input.
-		@param i input.
+	StringViewInput(std::string &&) = delete;
+	/**
+	 * Copies characters from the underlying storage.
 	 */
-	ParserPosition(Input &i);
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the entire range as a single run of bytes.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the number of characters.
+	 */
+	Index size() const override;
 };
 
 /**
- * The callback that handles matches.  The arguments are the start and end of
- * the matching range and some state for the current parse.
- * When constructing an AST using the AST infrastructure, this will be a lambda
- * binding the type of the AST node to create and the argument will be
- * interpreted as an AST stack.
- */
-typedef std::function<void(const ParserPosition&,
-                           const ParserPosition&, void*)> parse_proc;
-
-
-/**
- * A range within input.  This is passed to `construct()` methods for AST
- * classes and allows terminals to record the source location.
+ * A concrete Input subclass that refers to a range of 32-bit characters owned
+ * by the caller, without copying them.  The caller is responsible for ensuring
+ * that the characters remain valid and unmodified for as long as this object
+ * (and any `InputRange` referring to it) exists.
  */
-class InputRange
+class UnicodeSpanInput : public Input
 {
-public:
-	///begin position.
-	ParserPosition start;
-
-	///end position.
-	ParserPosition finish;
-
-	///empty constructor.
-	InputRange() {}
-
-	/** constructor.bbb
-		@param b begin position.
-		@param e end position.
+	/**
+	 * The start of the underlying data.
 	 */
-	InputRange(const ParserPosition &b, const ParserPosition &e);
+	const char32_t *characters;
 	/**
-	 * Iterator to the start of the input range.
+	 * The number of characters in the underlying data.
 	 */
-	Input::iterator begin() const { return start.it; }
+	Index length;
+	public:
 	/**
-	 * Iterator to the end of the input range.
+	 * Constructs the wrapper from `l` characters starting at `s`.
 	 */
-	Input::iterator end() const { return finish.it; }
+	UnicodeSpanInput(const char32_t *s, Index l) : characters(s), length(l) {}
 	/**
-	 * Convert this range to a std::string.
+	 * Provides direct access to the underlying storage.
 	 */
-	std::string str() const;
-};
-
-
-///enum with error types.
-enum ERROR_TYPE
-{
-	///syntax error
-	ERROR_SYNTAX_ERROR = 1,
-
-	///invalid end of file
-	ERROR_INVALID_EOF,
-
-	///first user error
-	ERROR_USER = 100
-};
-
-
-///Error.
-class Error : public InputRange
-{
-public:
-	///type
-	int error_type;
-
-	/** constructor.
-		@param b begin position.
-		@param e end position.
-		@param t type.
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the entire range as a single run of characters.
 	 */
-	Error(const ParserPosition &b, const ParserPosition &e, int t);
-
-	/** compare on begin position.
-		@param e the other error to compare this with.
-		@return true if this comes before the previous error, false otherwise.
+	bool characterSpan(Index n, const char32_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the number of characters.
 	 */
-	bool operator < (const Error &e) const;
+	Index size() const override;
 };
 
-
-///type of error list.
-typedef std::list<Error> ErrorList;
-
-/**
- * CharacterExpr is a concrete subclass of Expr, which is exposed to allow it to be 
- */
-class CharacterExpr;
-typedef std::shared_ptr<CharacterExpr> CharacterExprPtr;
-
 /**
- * A shared pointer to an expression.  All expression tree nodes use shared
- * pointers.  
+ * A concrete Input subclass that refers to a sequence of buffers, described
+ * by an array of `iovec` structures, as if they were a single string.  This
+ * allows (for example) a chain of network receive buffers to be parsed
+ * without first concatenating them.  As with `StringViewInput`, the data is
+ * not copied and the caller must ensure that it remains valid for as long as
+ * this object exists.  The array of `iovec` structures itself is copied and
+ * need not outlive the constructor call.
+ *
+ * Each buffer is exposed to the parser as a separate run of bytes.
  */
-struct ExprPtr : public std::shared_ptr<Expr>
+class IovecInput : public Input
 {
 	/**
-	 * Construct an expression pointer wrapping an expression.
+	 * A non-empty buffer in the sequence.
 	 */
-	ExprPtr(Expr *e) : std::shared_ptr<Expr>(e) {}
+	struct Fragment
+	{
+		/**
+		 * The data in this fragment.
+		 */
+		const uint8_t *data;
+		/**
+		 * The index of the first character of this fragment in the input.
+		 */
+		Index start;
+	};
 	/**
-	 * Construct an expression pointer wrapping an expression that refers to a rule.
+	 * The fragments, in order.  A sentinel entry with a null data pointer,
+	 * whose start is the size of the input, is stored at the end.
 	 */
-	ExprPtr(const Rule &e);
+	std::vector<Fragment> fragments;
 	/**
-	 * Construct an expression pointer wrapping a character expression.
+	 * The index (in `fragments`) of the fragment that was most recently
+	 * accessed.  Most accesses are close to the previous one, so this is
+	 * checked before searching.
 	 */
-	ExprPtr(const CharacterExprPtr &e);
+	std::size_t cursor;
 	/**
-	 * Construct an expression pointer wrapping a string expression created
-	 * from a string.
+	 * Returns the index in `fragments` of the fragment containing the
+	 * character at index `n`, which must be less than the size of the input.
 	 */
-	ExprPtr(const char *);
+	std::size_t fragmentForIndex(Index n);
+	public:
 	/**
-	 * Construct an expression pointer wrapping a character expression created
-	 * from a character.
+	 * Constructs the input from `count` buffers described by `iov`.
 	 */
-	ExprPtr(const char32_t);
-};
-
-
-/**
- * Rule class, which represents a rule in a grammar.  Rules are distinct from
+	IovecInput(const struct iovec *iov, int count);
+	/**
+	 * Copies characters from the fragment containing `start`.
+	 */
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the fragment containing `n` as a run of bytes.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the total number of characters in all of the fragments.
+	 */
+	Index size() const override;
+};
+
+/**
+ * A concrete `Input` class that wraps a file and reads it on a background
+ * thread, ahead of the parser.  This is intended for files where mapping is
+ * not appropriate (for example, on network filesystems, or where predictable
+ * memory usage is more important than peak throughput).  As with
+ * `AsciiFileInput`, the file is assumed to be in ASCII.
+ *
+ * The file is read in blocks of `block_size` bytes into a fixed set of
+ * `block_count` buffers.  While the parser is working on one block, the
+ * background thread fills the others with the blocks that follow it, so the
+ * latency of the reads overlaps with parsing.  Each block is exposed to the
+ * parser as a run of bytes.  Backtracking to a block that has been recycled
+ * causes it to be read again.
+ */
+class PrefetchFileInput : public Input
+{
+	public:
+	/**
+	 * The default size of each block.
+	 */
+	static const std::size_t default_block_size = 4 * 1024 * 1024;
+	/**
+	 * The default number of blocks.
+	 */
+	static const unsigned default_block_count = 3;
+	/**
+	 * Construct a parser input from a specified file descriptor, reading it in
+	 * blocks of `block_size` bytes into `block_count` buffers.  At least two
+	 * buffers are always used.  The file descriptor is not closed when this
+	 * object is destroyed, but must remain valid for as long as this object
+	 * exists.
+	 */
+	PrefetchFileInput(int file,
+	                  std::size_t block_size = default_block_size,
+	                  unsigned block_count = default_block_count);
+	/**
+	 * Stops the background thread.
+	 */
+	~PrefetchFileInput();
+	/**
+	 * Copying is not supported, as the background thread refers to this
+	 * object.
+	 */
+	PrefetchFileInput(const PrefetchFileInput&) = delete;
+	/**
+	 * Copies characters from the block containing `start` and the blocks
+	 * after it, until the buffer is full.
+	 */
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the block containing `n` as a run of bytes.  The block will not
+	 * be recycled until the next call to this method.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the size of the file.
+	 */
+	Index size() const override;
+	private:
+	/**
+	 * The size of the file.
+	 */
+	std::size_t file_size;
+	/**
+	 * Opaque type for the buffers and the state shared with the background
+	 * thread.
+	 */
+	struct Prefetcher;
+	/**
+	 * The buffers and the background thread.
+	 */
+	std::unique_ptr<Prefetcher> prefetcher;
+};
+
+/**
+ * A concrete `Input` class that reads incrementally from a file descriptor
+ * that need not refer to a regular file, such as a pipe or a socket.  The size
+ * of the input is not known until the end of the stream has been reached.  As
+ * with `AsciiFileInput`, the data is assumed to be in ASCII.
+ *
+ * Data is read in fixed-size chunks, on demand.  The parser informs the input
+ * (via `release()`) when it no longer needs data before the oldest point to
+ * which it may backtrack, or which may still be passed to a parse procedure,
+ * and chunks before that point are discarded and recycled.  Parsing therefore
+ * needs memory proportional to the amount of lookahead actually used, rather
+ * than to the length of the stream.  Note that this can only happen if the
+ * grammar allows it: if the root rule has a parse procedure, for example, then
+ * the entire stream must be retained.
+ */
+class StreamInput : public Input
+{
+	public:
+	/**
+	 * The default size of chunks.
+	 */
+	static const std::size_t default_chunk_size = 64 * 1024;
+	/**
+	 * Construct a parser input that reads from the specified file descriptor,
+	 * in chunks of `chunk` bytes.  The file descriptor is not closed when this
+	 * object is destroyed.
+	 */
+	StreamInput(int file, std::size_t chunk = default_chunk_size);
+	/**
+	 * Copies characters from the chunk containing `start`.
+	 */
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the chunk containing `n` as a run of bytes.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the size of the stream, once the end has been reached, or
+	 * `npos` before then.
+	 */
+	Index size() const override;
+	/**
+	 * Reads from the stream until the character at index `n` is available, or
+	 * the end of the stream is reached.
+	 */
+	bool available(Index n) override;
+	/**
+	 * Discards chunks that end at or before `n`.
+	 */
+	void release(Index n) override;
+	/**
+	 * Returns the number of bytes currently held in memory.
+	 */
+	std::size_t retainedSize() const { return chunks.size() * chunk_size; }
+	private:
+	/**
+	 * A chunk of data read from the stream.  All chunks except for the last
+	 * one are full.
+	 */
+	struct Chunk
+	{
+		/**
+		 * The data, `chunk_size` bytes.
+		 */
+		std::unique_ptr<uint8_t[]> data;
+		/**
+		 * The index of the first character in this chunk.
+		 */
+		Index start;
+		/**
+		 * The number of valid bytes in this chunk.
+		 */
+		std::size_t length;
+	};
+	/**
+	 * The file descriptor that this reads from.
+	 */
+	int fd;
+	/**
+	 * The size of each chunk.
+	 */
+	std::size_t chunk_size;
+	/**
+	 * The chunks currently held in memory, in order.
+	 */
+	std::deque<Chunk> chunks;
+	/**
+	 * Buffers from discarded chunks, kept for reuse.
+	 */
+	std::vector<std::unique_ptr<uint8_t[]>> spare;
+	/**
+	 * The number of characters read from the stream so far.
+	 */
+	Index read_end;
+	/**
+	 * Flag indicating whether the end of the stream has been reached.
+	 */
+	bool eof;
+	/**
+	 * Returns the chunk containing index `n`, reading more of the stream if
+	 * required, or null if `n` has been discarded or is beyond the end.
+	 */
+	Chunk *chunkForIndex(Index n);
+};
+
+/**
+ * A concrete `Input` class that wraps a UTF-8 encoded string.  Unlike
+ * `StringInput`, each index in this input refers to a Unicode code point, not
+ * to a byte.
+ *
+ * The string is validated when the input is constructed.  Runs of ASCII are
+ * detected a vector register at a time and are copied directly into the
+ * character buffer, so mostly-ASCII input costs little more than
+ * `StringInput`.  Invalid sequences are replaced by U+FFFD (the replacement
+ * character) and cause `isValid()` to return false.
+ *
+ * The byte offset of every `checkpoint_interval`th code point is recorded
+ * during validation, so that random access (for example, when backtracking)
+ * only needs to decode at most that many code points before reaching the
+ * requested index.
+ */
+class Utf8Input : public Input
+{
+	public:
+	/**
+	 * The number of code points between recorded byte offsets.
+	 */
+	static const Index checkpoint_interval = 64;
+	/**
+	 * Constructs the wrapper from a string (`s`).
+	 * The new object takes ownership of the character data in the string.
+	 */
+	Utf8Input(std::string &&s) : str(std::move(s)) { scan(); }
+	/**
+	 * Constructs the wrapper from a string (`s`).
+	 * The new object is copy-constructed from the string argument.
+	 */
+	Utf8Input(const std::string &s) : str(s) { scan(); }
+	/**
+	 * Returns an immutable reference to the underlying (UTF-8) string.  The
+	 * returned value is guaranteed to remain valid and not be modified for as
+	 * long as the input object exists.
+	 */
+	const std::string &getString() { return str; }
+	/**
+	 * Returns true if the string contained only well-formed UTF-8.
+	 */
+	bool isValid() const { return valid; }
+	/**
+	 * Returns true if the string contained only ASCII characters.  In this
+	 * case, code point indexes and byte offsets are the same.
+	 */
+	bool isASCII() const { return ascii; }
+	/**
+	 * Returns the offset in the underlying string of the first byte of the
+	 * code point at index `n`.  Passing the size of the input returns the
+	 * length of the string.
+	 */
+	std::size_t byteOffset(Index n) const;
+	/**
+	 * Returns the bytes in the underlying string that correspond to the
+	 * specified range, as a pointer to the first byte and a length.
+	 */
+	std::pair<const char*, std::size_t> bytes(const InputRange &r) const;
+	/**
+	 * Decodes characters from the underlying string.
+	 */
+	bool  fillBuffer(Index start, Index &length, char32_t *&b) override;
+	/**
+	 * Exposes the entire string as a single run of bytes, if it consists
+	 * solely of ASCII characters.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &end) override;
+	/**
+	 * Returns the number of code points in the string.
+	 */
+	Index size() const override;
+	private:
+	/**
+	 * The UTF-8 data.
+	 */
+	std::string str;
+	/**
+	 * The byte offsets of every `checkpoint_interval`th code point.
+	 */
+	std::vector<std::size_t> checkpoints;
+	/**
+	 * The number of code points in the string.
+	 */
+	Index length;
+	/**
+	 * The index of the code point immediately after the last one decoded by
+	 * `fillBuffer()`, allowing sequential refills to avoid searching from the
+	 * last checkpoint.
+	 */
+	Index cursor_index;
+	/**
+	 * The byte offset corresponding to `cursor_index`.
+	 */
+	std::size_t cursor_offset;
+	/**
+	 * Flag indicating whether the input is well-formed.
+	 */
+	bool valid;
+	/**
+	 * Flag indicating whether the input is entirely ASCII.
+	 */
+	bool ascii;
+	/**
+	 * Validates the string, counts the number of code points and records
+	 * the checkpoints.
+	 */
+	void scan();
+};
+
+/**
+ * A concrete `Input` class that reads from a pair of iterators.  The size of
+ * the range is computed once, on construction, and the iterators must remain
+ * valid for as long as this object exists.
+ *
+ * Random-access iterators are positioned directly.  For other iterators, this
+ * keeps a cursor at the end of the last range copied, so sequential reads
+ * only walk each element once.  If `T` is a pointer to bytes or to
+ * `char32_t`, the data is also exposed to the parser directly, without
+ * copying.
+ */
+template<class T>
+class IteratorInput : public Input
+{
+	/**
+	 * The iterator for the start of the input.
+	 */
+	T begin;
+	/**
+	 * The iterator for the end of the input.
+	 */
+	T end;
+	/**
+	 * The number of elements between `begin` and `end`.
+	 */
+	Index length;
+	/**
+	 * An iterator pointing to the element at `cursor_index`.  Only used for
+	 * iterators that are not random access.
+	 */
+	T cursor;
+	/**
+	 * The index of the element that `cursor` points to.
+	 */
+	Index cursor_index;
+	/**
+	 * Returns an iterator for the element at index `n`, for random-access
+	 * iterators.
+	 */
+	T iteratorAt(Index n, std::random_access_iterator_tag)
+	{
+		return begin + static_cast<typename std::iterator_traits<T>::difference_type>(n);
+	}
+	/**
+	 * Returns an iterator for the element at index `n`, for other iterators.
+	 * This walks forward from the cursor if possible, or from the start of the
+	 * input if `n` is before the cursor.
+	 */
+	T iteratorAt(Index n, std::forward_iterator_tag)
+	{
+		if (n < cursor_index)
+		{
+			cursor = begin;
+			cursor_index = 0;
+		}
+		std::advance(cursor, n - cursor_index);
+		cursor_index = n;
+		return cursor;
+	}
+	/**
+	 * Returns true if a pointer to `P` can be exposed as a pointer to `C`.
+	 */
+	template<typename C, typename P>
+	static constexpr bool isSpanOf()
+	{
+		typedef typename std::remove_cv<P>::type E;
+		return std::is_same<C, uint8_t>::value ?
+			(std::is_integral<E>::value && (sizeof(E) == 1) &&
+			 !std::is_same<E, bool>::value) :
+			std::is_same<C, E>::value;
+	}
+	/**
+	 * Fallback for `byteSpan()` and `characterSpan()` when the iterators are
+	 * not pointers of the correct type.
+	 */
+	template<typename C, typename I>
+	bool contiguousSpan(Index, const C *&, Index &, Index &, I)
+	{
+		return false;
+	}
+	/**
+	 * Implementation of `byteSpan()` and `characterSpan()` when the iterators
+	 * are pointers of the correct type.
+	 */
+	template<typename C, typename P>
+	typename std::enable_if<isSpanOf<C, P>(), bool>::type
+	contiguousSpan(Index n, const C *&data, Index &start, Index &stop, P *p)
+	{
+		if (n >= length)
+		{
+			return false;
+		}
+		data = reinterpret_cast<const C*>(p);
+		start = 0;
+		stop = length;
+		return true;
+	}
+	public:
+	/**
+	 * Construct an input that reads from between the two iterators specified.
+	 */
+	IteratorInput(T b, T e) :
+		begin(b), end(e),
+		length(static_cast<Index>(std::distance(b, e))),
+		cursor(b), cursor_index(0) {}
+	/**
+	 * Copy the data into the buffer.
+	 */
+	bool fillBuffer(Index start, Index &n, char32_t *&b) override
+	{
+		if (start >= length)
+		{
+			n = 0;
+			return false;
+		}
+		n = std::min(n, length - start);
+		typename std::iterator_traits<T>::iterator_category category;
+		T i = iteratorAt(start, category);
+		for (Index copied=0 ; copied < n ; ++copied, ++i)
+		{
+			b[copied] = static_cast<char32_t>(*i);
+		}
+		// Leave the cursor after the copied range, so that the next
+		// sequential refill starts where this one stopped.
+		cursor = i;
+		cursor_index = start + n;
+		return true;
+	}
+	/**
+	 * Exposes the input as bytes, if the iterators are pointers to bytes.
+	 */
+	bool byteSpan(Index n, const uint8_t *&data, Index &start, Index &stop) override
+	{
+		return contiguousSpan(n, data, start, stop, begin);
+	}
+	/**
+	 * Exposes the input as characters, if the iterators are pointers to
+	 * `char32_t`.
+	 */
+	bool characterSpan(Index n, const char32_t *&data, Index &start, Index &stop) override
+	{
+		return contiguousSpan(n, data, start, stop, begin);
+	}
+	/**
+	 * Returns the size of the input.
+	 */
+	Index size() const override { return length; }
+};
+
+
+///position into the input.
+struct ParserPosition
+{
+	///iterator into the input.
+	Input::iterator it;
+
+	///line.
+	int line;
+
+	///column.
+	int col;
+
+	///null constructor.
+	ParserPosition() {}
+
+	/** constructor from input.
+		@param i input.
+	 */
+	ParserPosition(Input &i);
+};
+
+/**
+ * The callback that handles matches.  The arguments are the start and end of
+ * the matching range and some state for the current parse.
+ * When constructing an AST using the AST infrastructure, this will be a lambda
+ * binding the type of the AST node to create and the argument will be
+ * interpreted as an AST stack.
+ */
+typedef std::function<void(const ParserPosition&,
+                           const ParserPosition&, void*)> parse_proc;
+
+
+/**
+ * A range within input.  This is passed to `construct()` methods for AST
+ * classes and allows terminals to record the source location.
+ */
+class InputRange
+{
+public:
+	///begin position.
+	ParserPosition start;
+
+	///end position.
+	ParserPosition finish;
+
+	///empty constructor.
+	InputRange() {}
+
+	/** constructor.bbb
+		@param b begin position.
+		@param e end position.
+	 */
+	InputRange(const ParserPosition &b, const ParserPosition &e);
+	/**
+	 * Iterator to the start of the input range.
+	 */
+	Input::iterator begin() const { return start.it; }
+	/**
+	 * Iterator to the end of the input range.
+	 */
+	Input::iterator end() const { return finish.it; }
+	/**
+	 * Convert this range to a std::string.
+	 */
+	std::string str() const;
+};
+
+
+///enum with error types.
+enum ERROR_TYPE
+{
+	///syntax error
+	ERROR_SYNTAX_ERROR = 1,
+
+	///invalid end of file
+	ERROR_INVALID_EOF,
+
+	///first user error
+	ERROR_USER = 100
+};
+
+
+///Error.
+class Error : public InputRange
+{
+public:
+	///type
+	int error_type;
+
+	/** constructor.
+		@param b begin position.
+		@param e end position.
+		@param t type.
+	 */
+	Error(const ParserPosition &b, const ParserPosition &e, int t);
+
+	/** compare on begin position.
+		@param e the other error to compare this with.
+		@return true if this comes before the previous error, false otherwise.
+	 */
+	bool operator < (const Error &e) const;
+};
+
+
+///type of error list.
+typedef std::list<Error> ErrorList;
+
+/**
+ * CharacterExpr is a concrete subclass of Expr, which is exposed to allow it to be 
+ */
+class CharacterExpr;
+typedef std::shared_ptr<CharacterExpr> CharacterExprPtr;
+
+/**
+ * A shared pointer to an expression.  All expression tree nodes use shared
+ * pointers.  
+ */
+struct ExprPtr : public std::shared_ptr<Expr>
+{
+	/**
+	 * Construct an expression pointer wrapping an expression.
+	 */
+	ExprPtr(Expr *e) : std::shared_ptr<Expr>(e) {}
+	/**
+	 * Construct an expression pointer wrapping an expression that refers to a rule.
+	 */
+	ExprPtr(const Rule &e);
+	/**
+	 * Construct an expression pointer wrapping a character expression.
+	 */
+	ExprPtr(const CharacterExprPtr &e);
+	/**
+	 * Construct an expression pointer wrapping a string expression created
+	 * from a string.
+	 */
+	ExprPtr(const char *);
+	/**
+	 * Construct an expression pointer wrapping a character expression created
+	 * from a character.
+	 */
+	ExprPtr(const char32_t);
+};
+
+
+/**
+ * Policies for memoizing the results of a rule.  Memoizing a rule avoids
+ * parsing it more than once at the same position, but every use of the rule
+ * then pays for a lookup in the memo table, which costs more than reparsing
+ * small rules.
+ */
+enum MemoPolicy
+{
+	///always memoize the rule
+	MEMO_ALWAYS,
+
+	///never memoize the rule
+	MEMO_NEVER,
+
+	///memoize the rule until a warm-up parse (see `ParseOptions::memo_warm_up`)
+	///has sampled how often the memo table is hit, then follow its choice
+	///between `MEMO_ALWAYS` and `MEMO_NEVER`
+	MEMO_AUTO
+};
+
+/**
+ * Rule class, which represents a rule in a grammar.  Rules are distinct from
  * expressions, in that they are expected to be top-level constructs that can
  * have actions associated with them.
  */
@@ -552,11 +1383,81 @@ public:
 	 * initialisation without performing copying.
 	 */
 	Rule(const Rule &&r);
+	/**
+	 * Destroys the rule, along with any bytecode compiled for it.
+	 */
+	~Rule();
+	/**
+	 * Sets the memoization policy for this rule.  The default is
+	 * `MEMO_ALWAYS`.  This resets any choice made by a warm-up parse and
+	 * should not be called while the rule is being used to parse.
+	 */
+	void setMemoPolicy(MemoPolicy p);
+	/**
+	 * Returns the memoization policy that was set for this rule.
+	 */
+	MemoPolicy memoPolicy() const { return memo_policy; }
+	/**
+	 * Returns the memoization policy that is in effect for this rule.  For
+	 * rules using `MEMO_AUTO`, this is `MEMO_AUTO` until a warm-up parse has
+	 * sampled the rule, and then whichever of `MEMO_ALWAYS` or `MEMO_NEVER`
+	 * it chose.  The result can be passed to `setMemoPolicy()` to fix the
+	 * choice.
+	 */
+	MemoPolicy chosenMemoPolicy() const
+	{
+		return static_cast<MemoPolicy>(memo_state.load(std::memory_order_relaxed));
+	}
 private:
 	/**
 	 * The expression that this rule invokes.
 	 */
 	const ExprPtr expr;
+	/**
+	 * The memoization policy that was set for this rule.
+	 */
+	MemoPolicy memo_policy;
+	/**
+	 * The memoization policy in effect (see `chosenMemoPolicy()`).
+	 */
+	mutable std::atomic<int> memo_state;
+	/**
+	 * The bytecode for this rule, as a non-terminal and as a terminal.  These
+	 * are compiled when the rule is first parsed in each way.
+	 */
+	mutable std::atomic<const Program*> programs[2];
+	/**
+	 * Returns the bytecode for this rule, compiling it if necessary.
+	 */
+	const Program &program(bool term) const;
+	/**
+	 * The functions emitted by `generateParser()` for parsing this rule as a
+	 * non-terminal and as a terminal, or null if none have been installed.
+	 */
+	mutable GeneratedRule generated[2];
+	/**
+	 * The characters that can start a match of this rule, as a non-terminal
+	 * and as a terminal.  These are computed when a choice that refers to
+	 * the rule is compiled.
+	 */
+	mutable std::atomic<const FirstSet*> first_sets[2];
+	/**
+	 * The numbering of the rules reachable from this rule, when it is used as
+	 * the root of a grammar.  This is built when the rule is first parsed as
+	 * a root.
+	 */
+	mutable std::atomic<const GrammarLayout*> grammar_layout;
+	/**
+	 * Returns the numbering of the rules reachable from this rule and from
+	 * the whitespace rule `ws`, building it if necessary.
+	 */
+	const GrammarLayout &layout(const Rule &ws) const;
+	/**
+	 * A small integer that uniquely identifies this rule.  IDs are allocated
+	 * sequentially as rules are constructed and are used by the parser to
+	 * key its memo table.
+	 */
+	const uint32_t id;
 
 	/**
 	 * Copying rules is not allowed.
@@ -564,6 +1465,11 @@ private:
 	Rule &operator = (const Rule &) = delete;
 
 	friend class Context;
+	friend class GeneratedContext;
+	friend class FirstSet;
+	friend class GrammarLayout;
+	friend bool generateParser(FILE *, const GeneratorOptions &,
+	                           const std::vector<GeneratorRule> &);
 };
 
 /**
@@ -587,13 +1493,40 @@ public:
 	 * contain whitespace around compound expressions, as defined by the
 	 * whitespace rule in the context.
 	 */
-	virtual bool parse_non_term(Context &con) const = 0;
+	virtual bool parse_non_term(Context &con) const = 0;
+
+	/**
+	 * Parse this expression as a terminal.  Terminals are exact matches for
+	 * the specified expression, without any whitespace.
+	 */
+	virtual bool parse_term(Context &con) const = 0;
+
+	/**
+	 * Compile this expression into the bytecode for the rule being compiled
+	 * by `b`, as a terminal if `term` is true or a non-terminal otherwise.
+	 * The default implementation emits an instruction that calls
+	 * `parse_term()` or `parse_non_term()`, so subclasses only need to
+	 * override this to make their parsing visible to the compiler.
+	 */
+	virtual void compile(ProgramBuilder &b, bool term) const;
+
+	/**
+	 * Add the characters that can start a match of this expression to `set`,
+	 * as a terminal if `term` is true or a non-terminal otherwise, and mark
+	 * the set as nullable if the expression can match without consuming the
+	 * next character.  The compiler uses these to skip the alternatives of
+	 * a choice that can't match.  The default implementation assumes that
+	 * anything can happen, which is always safe.
+	 */
+	virtual void first(FirstSet &set, bool term) const;
 
 	/**
-	 * Parse this expression as a terminal.  Terminals are exact matches for
-	 * the specified expression, without any whitespace.
+	 * Adds the rules that this expression refers to, directly or through its
+	 * subexpressions, to `rules`.  The parser uses this to number the rules
+	 * in a grammar.  Expressions that refer to rules must override this.
+	 * The default implementation does nothing.
 	 */
-	virtual bool parse_term(Context &con) const = 0;
+	virtual void rules(std::vector<const Rule*> &rules) const;
 
 	/**
 	 * Dump the current rule.  Used for debugging.
@@ -756,6 +1689,25 @@ ExprPtr eof();
  */
 ExprPtr any();
 
+
+/** creates an expression that commits the parser to the parse so far.
+	The expression always succeeds without consuming any input.  Once it has
+	been parsed, the parser will never backtrack to before it: if anything
+	after it fails, then enclosing choices, optionals and loops fail instead
+	of trying alternatives, and so the whole parse fails.  In exchange, the
+	parser discards its memo table and its record of earlier matches, and a
+	streaming input may discard the data before this point.  This keeps
+	memory proportional to the input between commits, for example by
+	committing after each statement in a list.
+
+	The parse procedures for the matches before this point are run
+	immediately, rather than after the parse succeeds, so they are run even
+	if the parse later fails.  Commits should not be used in `&` or `!`
+	predicates.
+	@return the appropriate expression.
+ */
+ExprPtr commit();
+
 /**
  * Returns a new expression that is always successfully matched and executes
  * the argument function when it is matched.
@@ -778,6 +1730,271 @@ struct ParserDelegate
 	virtual ~ParserDelegate();
 };
 
+/**
+ * A region of memory from which allocations are made by advancing a pointer.
+ * Individual allocations are never freed: all of the memory is released at
+ * once, when the arena is reset or destroyed.  Parsing with an arena (see
+ * `ParseOptions::arena`) allocates the parser's tables, and the AST if the AST
+ * layer is in use, from the arena, so that a whole parse costs only a few
+ * calls to `malloc()`.
+ *
+ * An arena is not thread safe and may be used by only one parse at a time.
+ * Anything allocated in it, including an AST, must be destroyed before the
+ * arena is reset.
+ */
+class Arena
+{
+public:
+	/**
+	 * Constructs an arena that allocates memory from the heap in chunks of
+	 * `chunk_size` bytes.  Larger allocations are given chunks of their own.
+	 */
+	explicit Arena(size_t chunk_size = 64 * 1024);
+	/**
+	 * Destroys the arena, releasing all of its memory.
+	 */
+	~Arena();
+	/**
+	 * Allocates `size` bytes with the specified alignment, which must be a
+	 * power of two no greater than that of `std::max_align_t`.
+	 */
+	void *allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+	{
+		uintptr_t p = (reinterpret_cast<uintptr_t>(next) + alignment - 1) &
+		              ~static_cast<uintptr_t>(alignment - 1);
+		uintptr_t limit = reinterpret_cast<uintptr_t>(end);
+		if ((next == nullptr) || (p > limit) || (size > limit - p))
+		{
+			return allocateSlow(size);
+		}
+		next = reinterpret_cast<char*>(p + size);
+		used += size;
+		return reinterpret_cast<void*>(p);
+	}
+	/**
+	 * Discards everything allocated in the arena, keeping its memory for
+	 * reuse.  If more than one chunk was in use, they are replaced by a
+	 * single chunk as large as all of them, so an arena that is reset after
+	 * each parse stops calling `malloc()` once it has grown to fit.
+	 */
+	void reset();
+	/**
+	 * Discards everything allocated in the arena and releases all of its
+	 * memory.
+	 */
+	void release();
+	/**
+	 * Returns the number of bytes allocated from the arena since it was last
+	 * reset.
+	 */
+	size_t bytesUsed() const { return used; }
+	/**
+	 * Returns the number of bytes that the arena has obtained from the heap.
+	 */
+	size_t bytesReserved() const { return reserved; }
+private:
+	/**
+	 * The header at the start of each chunk.
+	 */
+	struct Chunk
+	{
+		//the previously allocated chunk
+		Chunk *previous;
+		//the size of the chunk, including this header
+		size_t size;
+	};
+	/**
+	 * Allocates from a new chunk.
+	 */
+	void *allocateSlow(size_t size);
+	//the size of normal chunks
+	const size_t chunk_size;
+	//the chunk that allocations are currently made from
+	Chunk *current = nullptr;
+	//the chunks that were filled or were made for large allocations
+	Chunk *full = nullptr;
+	//the next free byte in the current chunk
+	char *next = nullptr;
+	//the end of the current chunk
+	char *end = nullptr;
+	//the number of bytes allocated since the last reset
+	size_t used = 0;
+	//the number of bytes obtained from the heap
+	size_t reserved = 0;
+	Arena(const Arena&) = delete;
+	Arena &operator=(const Arena&) = delete;
+};
+
+/**
+ * An allocator for standard containers that allocates from an `Arena`.  An
+ * allocator with no arena uses the heap, so containers can switch between
+ * the two at run time.
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+	typedef T value_type;
+	/**
+	 * A container that is assigned a copy keeps its own arena and copies the
+	 * elements into it, so that the copy lives as long as the container does.
+	 */
+	typedef std::false_type propagate_on_container_copy_assignment;
+	/**
+	 * A container that is assigned by moving takes the arena along with the
+	 * elements, so that moving never copies.
+	 */
+	typedef std::true_type propagate_on_container_move_assignment;
+	/**
+	 * Containers exchange arenas along with their elements, so that
+	 * containers using different arenas can be swapped.
+	 */
+	typedef std::true_type propagate_on_container_swap;
+	/**
+	 * Constructs an allocator using `a`, or the heap if `a` is null.
+	 */
+	ArenaAllocator(Arena *a = nullptr) noexcept : arena(a) {}
+	/**
+	 * Constructs an allocator for `T` using the same arena as `o`.
+	 */
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U> &o) noexcept : arena(o.arena) {}
+	/**
+	 * Allocates space for `n` objects.
+	 */
+	T *allocate(size_t n)
+	{
+		if (arena)
+		{
+			return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+	/**
+	 * Frees the space for `n` objects.  This does nothing for an arena.
+	 */
+	void deallocate(T *p, size_t) noexcept
+	{
+		if (!arena)
+		{
+			::operator delete(p);
+		}
+	}
+	/**
+	 * The arena, or null for the heap.
+	 */
+	Arena *arena;
+};
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+	return a.arena == b.arena;
+}
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+	return a.arena != b.arena;
+}
+
+/**
+ * Counters describing the work done by a parse.  These are intended for
+ * tuning grammars and for measuring the effect of memoization.
+ */
+struct ParseStatistics
+{
+	/**
+	 * The number of times that a rule was parsed, rather than its result
+	 * being taken from the memo table.
+	 */
+	uint64_t rule_parses = 0;
+	/**
+	 * The number of successful matches that were taken from the memo table.
+	 */
+	uint64_t memo_hits = 0;
+	/**
+	 * The number of failures that were taken from the memo table.
+	 */
+	uint64_t memo_failure_hits = 0;
+	/**
+	 * The number of results stored in the memo table.
+	 */
+	uint64_t memo_insertions = 0;
+	/**
+	 * The number of results evicted from the memo table to keep it within
+	 * its budget.
+	 */
+	uint64_t memo_evictions = 0;
+	/**
+	 * An estimate of the number of times that a rule was parsed because its
+	 * result had been evicted from the memo table.
+	 */
+	uint64_t memo_reparses = 0;
+	/**
+	 * The number of times that a choice looked at the next character to
+	 * decide which of its alternatives to try.
+	 */
+	uint64_t choice_dispatches = 0;
+	/**
+	 * The number of alternatives of choices that were not tried, because
+	 * they can't start with the next character.
+	 */
+	uint64_t alternatives_skipped = 0;
+};
+
+/**
+ * Options that control a parse.
+ */
+struct ParseOptions
+{
+	/**
+	 * The maximum number of results to keep in the memo table, or zero for
+	 * no limit.  When the table is full, it is reduced to half of this size
+	 * by evicting results by start position.
+	 */
+	size_t memo_budget = 1 << 18;
+	/**
+	 * The number of characters behind the current position for which results
+	 * are kept in preference to others when evicting.  Results that start
+	 * further back than this are always evicted first.
+	 */
+	size_t memo_lookbehind = 16384;
+	/**
+	 * The arena from which to allocate the parser's tables, or null to use
+	 * the heap.  When parsing into an AST, the nodes are allocated from it
+	 * too.
+	 */
+	Arena *arena = nullptr;
+	/**
+	 * Flag indicating whether rules are compiled into bytecode for parsing.
+	 * The compiler joins consecutive literals in terminals into strings and
+	 * choices between single characters into sets, and lets choices skip
+	 * alternatives that can't start with the next character.  If this is
+	 * false, then the parser walks the expression trees instead, and doesn't
+	 * use code from `generateParser()` either.  This can be useful for
+	 * comparison or debugging.  Compiling doesn't change the cost of invoking
+	 * rules, so grammars that spend most of their time doing that, such as
+	 * the left-recursive calculator grammar, parse no faster.
+	 */
+	bool compile_rules = true;
+	/**
+	 * Flag indicating whether failed attempts to parse a rule are memoized, as
+	 * well as successful ones.  Without this, a rule that fails is parsed
+	 * again each time that it is tried at the same position, which can take
+	 * exponential time.  This can be useful for comparison.
+	 */
+	bool memoize_failures = true;
+	/**
+	 * Flag indicating that this is a warm-up parse.  While parsing, the
+	 * parser samples how often the memo table is hit for each rule using
+	 * `MEMO_AUTO`, and at the end it chooses whether each of them is worth
+	 * memoizing (see `Rule::chosenMemoPolicy()`).  The choice applies to
+	 * every later parse using the rules, so the input should be typical of
+	 * the workload.  Rules that are not reached often enough to judge keep
+	 * their previous policy.
+	 */
+	bool memo_warm_up = false;
+};
+
 /** parses the given input.
 	The parse procedures of each rule parsed are executed
 	before this function returns, if parsing succeeds.
@@ -791,6 +2008,365 @@ struct ParserDelegate
 bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
            const ParserDelegate &delegate, void *d);
 
+/** parses the given input, recording statistics about the parse.
+	This is identical to the version without the `statistics` parameter,
+	except that counters for the work done are returned.
+	@param statistics filled in with the counters for this parse.
+	@return true on parsing success, false on failure.
+ */
+bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+           const ParserDelegate &delegate, void *d,
+           ParseStatistics &statistics);
+
+/** parses the given input with the specified options, recording statistics
+	about the parse.
+	@param options the options for this parse.
+	@param statistics filled in with the counters for this parse.
+	@return true on parsing success, false on failure.
+ */
+bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+           const ParserDelegate &delegate, void *d,
+           const ParseOptions &options, ParseStatistics &statistics);
+
+/**
+ * The state used while parsing, kept for reuse by later parses.  Parsing
+ * builds a memo table and a log of matches, which can grow large.  A session
+ * keeps this storage between parses, so that parsing many small inputs
+ * doesn't reallocate it each time.  The `parse()` functions use a pool of
+ * sessions for each thread, so most programs don't need to create one
+ * explicitly.
+ *
+ * A session may be used by only one parse at a time.
+ */
+class ParseSession
+{
+public:
+	/**
+	 * Constructs a session with empty tables.
+	 */
+	ParseSession();
+	/**
+	 * Destroys the session, releasing its storage.
+	 */
+	~ParseSession();
+	/** parses the given input, reusing the storage from the last parse.
+		The arguments and the result are the same as for `pegmatite::parse()`.
+	 */
+	bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+	           const ParserDelegate &delegate, void *d);
+	/** parses the given input with the specified options, reusing the
+		storage from the last parse.  The arguments and the result are the
+		same as for `pegmatite::parse()`.
+	 */
+	bool parse(Input &i, const Rule &g, const Rule &ws, ErrorList &el,
+	           const ParserDelegate &delegate, void *d,
+	           const ParseOptions &options, ParseStatistics &statistics);
+	/**
+	 * Discards the results of the last parse, but keeps the memory that they
+	 * used.  This is done automatically at the start of each parse.
+	 */
+	void reset();
+private:
+	/**
+	 * The storage for the parser's tables.
+	 */
+	struct Storage;
+	friend class Context;
+	/**
+	 * The storage for this session.
+	 */
+	std::unique_ptr<Storage> storage;
+	ParseSession(const ParseSession&) = delete;
+	ParseSession &operator=(const ParseSession&) = delete;
+};
+
+/**
+ * Options for `generateParser()`.
+ */
+struct GeneratorOptions
+{
+	/**
+	 * The header that declares the grammar class and the install function.
+	 */
+	std::string header;
+	/**
+	 * The grammar class.  Each rule passed to the generator is named by the
+	 * member of this class that holds it.
+	 */
+	std::string grammar;
+	/**
+	 * The name of the install function.  The generated code defines this as
+	 * `bool function(const grammar &g)`, which installs the generated code
+	 * for the rules of `g` and returns false if any of them have changed
+	 * since the code was generated.
+	 */
+	std::string function = "installParser";
+};
+
+/**
+ * A rule passed to `generateParser()`.
+ */
+struct GeneratorRule
+{
+	//constructor
+	GeneratorRule(const std::string &n, const Rule &r) :
+		name(n), rule(std::addressof(r)) {}
+	//the member of the grammar class that holds the rule
+	std::string name;
+	//the rule
+	const Rule *rule;
+};
+
+/**
+ * Writes a C++ source file to `out` that parses each of the rules in `rules`
+ * without walking their expression trees.  Each rule becomes a pair of
+ * functions, for parsing it as a non-terminal and as a terminal, with
+ * characters and strings matched inline.
+ *
+ * The generated file is not a standalone parser.  References to other rules
+ * and expressions that have no inline form, such as regular expressions, are
+ * parsed by calling back into the library through the rule's bytecode, so the
+ * code must be linked against Pegmatite and installed on the same grammar
+ * objects that it was generated from.  Once installed, parsing uses it in
+ * place of the rules' bytecode.  Rules are still memoized and reported to the
+ * `ParserDelegate` as before, so no other code needs to change.  Returns
+ * false if writing fails.
+ */
+bool generateParser(FILE *out, const GeneratorOptions &options,
+                    const std::vector<GeneratorRule> &rules);
+
+/**
+ * The state of a parse that code using a `GeneratedContext` accesses directly,
+ * so that the common operations can be inlined.  This is part of the parser's
+ * context.
+ */
+struct ParserCursor
+{
+	//constructor
+	ParserCursor(Input &i) : position(i), error_pos(i) {}
+
+	//current position
+	ParserPosition position;
+
+	//Error position
+	ParserPosition error_pos;
+
+	//the current point in the match log
+	uint32_t matches = 0;
+
+	/**
+	 * The number of cuts that have been parsed.
+	 */
+	uint64_t cuts = 0;
+
+	/**
+	 * Flag indicating whether the size of the input was unknown when parsing
+	 * started.  Inputs of this kind may be buffering data that can be
+	 * discarded once the parser can no longer refer to it, so the parser
+	 * tracks the oldest point that it may need and informs the input.
+	 */
+	bool streaming = false;
+
+	/**
+	 * Direct access to the input's storage, for inputs that support it (see
+	 * `Input::byteSpan()` and `Input::characterSpan()`).  One of
+	 * `span_bytes` or `span_characters` points to the character at index
+	 * `span_start`, depending on the kind of input, and the run is
+	 * `span_length` characters long.  For other inputs, the run is empty and
+	 * characters are read via the input's iterators.
+	 */
+	const uint8_t *span_bytes = nullptr;
+	//32-bit storage for the current run
+	const char32_t *span_characters = nullptr;
+	//start index of the current run
+	Input::Index span_start = 0;
+	//length of the current run
+	Input::Index span_length = 0;
+};
+
+/**
+ * The interface between the parser and code that parses without walking
+ * expression trees: the code emitted by `generateParser()` and the expression
+ * templates in expression_templates.hh.  Programs don't normally use this
+ * class directly.
+ */
+class GeneratedContext
+{
+public:
+	/**
+	 * Installs `non_term` and `term` as the functions for parsing `r`.  The
+	 * fingerprints identify the bytecode that they were generated from.  If
+	 * the rule no longer compiles to the same bytecode, the functions are not
+	 * installed and this returns false.
+	 */
+	static bool install(const Rule &r, GeneratedRule non_term,
+	                    uint64_t non_term_fingerprint, GeneratedRule term,
+	                    uint64_t term_fingerprint);
+	/**
+	 * Returns the current character in `c`, or false at the end of the input.
+	 */
+	bool peek(char32_t &c)
+	{
+		Input::Index offset = cursor.position.it.index() - cursor.span_start;
+		if (offset < cursor.span_length)
+		{
+			c = cursor.span_bytes ? cursor.span_bytes[offset] :
+			                        cursor.span_characters[offset];
+			return true;
+		}
+		return peekSlow(c);
+	}
+	/**
+	 * Advances past the current character.
+	 */
+	void advance()
+	{
+		++cursor.position.it;
+		++cursor.position.col;
+	}
+	/**
+	 * Records that the current character failed to match.
+	 */
+	void mismatch()
+	{
+		if (cursor.position.it > cursor.error_pos.it)
+		{
+			cursor.error_pos = cursor.position;
+		}
+	}
+	/**
+	 * Matches the character `c`.
+	 */
+	bool character(char32_t c)
+	{
+		char32_t ch;
+		if (peek(ch) && (ch == c))
+		{
+			advance();
+			return true;
+		}
+		mismatch();
+		return false;
+	}
+	/**
+	 * Matches any character.
+	 */
+	bool any();
+	/**
+	 * Parses whitespace.
+	 */
+	void whitespace();
+	/**
+	 * Advances the position to the start of the next line.
+	 */
+	void newline();
+	/**
+	 * Parses the expression or rule that instruction `i` of the rule's
+	 * bytecode refers to.
+	 */
+	bool call(uint32_t i);
+	/**
+	 * Returns the index of the first alternative that can start with the
+	 * next character, for the choice whose dispatch table is instruction `i`
+	 * of the rule's bytecode, or `UINT32_MAX` if none can.
+	 */
+	uint32_t dispatch(uint32_t i);
+	/**
+	 * Parses the rule `r`, as a terminal if `term` is true or as a
+	 * non-terminal otherwise.
+	 */
+	bool rule(const Rule &r, bool term);
+	/**
+	 * Parses the expression `e`, as a terminal if `term` is true or as a
+	 * non-terminal otherwise.
+	 */
+	bool expression(const Expr &e, bool term);
+	/**
+	 * A saved state of the parse, which can be returned to with `reset()`.
+	 * These are kept by the caller, rather than on a stack in the parser.
+	 */
+	struct Mark
+	{
+		//the position
+		ParserPosition position;
+		//the point in the match log
+		uint32_t matches;
+		//the number of cuts that had been parsed
+		uint64_t cuts;
+	};
+	/**
+	 * Saves the state of the parse.  Each mark must be passed to either
+	 * `reset()` or `release()`, in the reverse of the order they were made.
+	 */
+	Mark mark()
+	{
+		if (cursor.streaming)
+		{
+			pin();
+		}
+		return { cursor.position, cursor.matches, cursor.cuts };
+	}
+	/**
+	 * Discards the mark `m` after parsing has succeeded.
+	 */
+	void release(const Mark &)
+	{
+		if (cursor.streaming)
+		{
+			unpin();
+		}
+	}
+	/**
+	 * Returns to the mark `m` after parsing has failed.  Returns false if
+	 * this isn't possible because a cut has been parsed since.
+	 */
+	bool reset(const Mark &m)
+	{
+		release(m);
+		if (m.cuts != cursor.cuts)
+		{
+			return false;
+		}
+		cursor.position = m.position;
+		cursor.matches = m.matches;
+		return true;
+	}
+private:
+	//constructor
+	GeneratedContext(Context &c, ParserCursor &cur, const Program *p) :
+		context(c), cursor(cur), program(p) {}
+	//fetches the current character when it isn't in the current run
+	bool peekSlow(char32_t &c);
+	//records a backtrack point for a streaming input
+	void pin();
+	//discards the most recent backtrack point for a streaming input
+	void unpin();
+	//the parser
+	Context &context;
+	//the parts of the parser's state that are accessed directly
+	ParserCursor &cursor;
+	//the bytecode that the code was generated from, if any
+	const Program *program;
+	friend class Context;
+	friend class GeneratedExpr;
+};
+
+/**
+ * Base class for expressions that parse through a `GeneratedContext`, rather
+ * than by calling other expressions.
+ */
+class GeneratedExpr : public Expr
+{
+public:
+	/**
+	 * Parses the expression, as a terminal if `term` is true or as a
+	 * non-terminal otherwise.
+	 */
+	virtual bool match(GeneratedContext &c, bool term) const = 0;
+	virtual bool parse_non_term(Context &con) const;
+	virtual bool parse_term(Context &con) const;
+};
+
 
 /** output the specific input range to the specific stream.
 	@param stream stream.
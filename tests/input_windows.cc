@@ -0,0 +1,256 @@
+/**
+ * Checks that inputs accessed through their window of characters return the
+ * right characters when reading backwards, after the window has moved past
+ * the characters being read.  Each window that misses backwards starts some
+ * way before the character that missed, so it must reach across the
+ * boundaries between the pieces that the input is stored in.
+ *
+ * Also checks that a parse of a stream that fails at the end of the input
+ * reports the end of the input, even though the end isn't known in advance.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "pegmatite.hh"
+
+using namespace pegmatite;
+
+namespace
+{
+/**
+ * The number of failed checks.
+ */
+int failures = 0;
+
+/**
+ * Records a failed check if `ok` is false.
+ */
+void check(bool ok, const char *test, const char *what)
+{
+	if (!ok)
+	{
+		fprintf(stderr, "%s: %s\n", test, what);
+		failures++;
+	}
+}
+
+/**
+ * Returns a list of words, separated by spaces.
+ */
+std::string words()
+{
+	std::string text;
+	for (int i=0 ; i<300 ; i++)
+	{
+		text += "w" + std::to_string(i) + " ";
+	}
+	return text;
+}
+
+/**
+ * Reads all of `input` forwards and then backwards, and checks that it
+ * contains `text`.  The window is kept small, so that reads miss often.
+ */
+void checkReads(const char *test, Input &input, const std::string &text)
+{
+	input.setWindowSize(16);
+	bool ok = true;
+	for (size_t i=0 ; i<text.size() ; i++)
+	{
+		ok &= (input[i] == static_cast<unsigned char>(text[i]));
+	}
+	check(ok, test, "wrong character reading forwards");
+	ok = true;
+	for (size_t i=text.size() ; i-->0 ; )
+	{
+		ok &= (input[i] == static_cast<unsigned char>(text[i]));
+	}
+	check(ok, test, "wrong character reading backwards");
+}
+
+/**
+ * A list of words.
+ */
+struct WordGrammar
+{
+	Rule ws    = " "_E;
+	Rule word  = term('w'_E >> +range('0', '9'));
+	Rule words = *word;
+};
+
+/**
+ * A delegate that records the text of each word, from the input, when its
+ * match is processed after the parse.  By then the window has moved on to
+ * the end of the input, so each word is read backwards.
+ */
+struct WordCollector : public ParserDelegate
+{
+	const Rule *word;
+	mutable std::vector<std::string> found;
+	parse_proc get_parse_proc(const Rule &r) const override
+	{
+		if (std::addressof(r) != word)
+		{
+			return parse_proc();
+		}
+		return [this](const ParserPosition &b, const ParserPosition &e, void*)
+			{
+				found.push_back(InputRange(b, e).str());
+			};
+	}
+};
+
+/**
+ * Parses `input` and checks that the text of each word matches `text`.
+ */
+void checkParse(const char *test, Input &input, const std::string &text)
+{
+	input.setWindowSize(16);
+	WordGrammar g;
+	WordCollector delegate;
+	delegate.word = std::addressof(g.word);
+	ErrorList errors;
+	check(parse(input, g.words, g.ws, errors, delegate, nullptr), test,
+	      "parse failed");
+	std::string joined;
+	for (const std::string &w : delegate.found)
+	{
+		joined += w + " ";
+	}
+	check(joined == text, test, "wrong text for the words");
+}
+
+/**
+ * Returns a stream of 8-byte chunks that reads `text` from a pipe.  The pipe
+ * is filled and closed before reading, so `text` must fit in its buffer.
+ */
+std::unique_ptr<StreamInput> stream(const std::string &text)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		perror("pipe");
+		return nullptr;
+	}
+	ssize_t written = write(fds[1], text.data(), text.size());
+	close(fds[1]);
+	if (written != static_cast<ssize_t>(text.size()))
+	{
+		perror("write");
+		close(fds[0]);
+		return nullptr;
+	}
+	return std::unique_ptr<StreamInput>(new StreamInput(fds[0], 8));
+}
+
+/**
+ * Parses a stream whose last word is cut short, and checks that the error is
+ * reported at the end of the input.
+ */
+void checkStreamEOF()
+{
+	std::string text = "w1 w2 w";
+	std::unique_ptr<StreamInput> input = stream(text);
+	if (!input)
+	{
+		check(false, "stream eof", "no stream");
+		return;
+	}
+	WordGrammar g;
+	WordCollector delegate;
+	delegate.word = std::addressof(g.word);
+	ErrorList errors;
+	check(!parse(*input, g.words, g.ws, errors, delegate, nullptr),
+	      "stream eof", "parse succeeded");
+	check(errors.size() == 1, "stream eof", "wrong number of errors");
+	if (!errors.empty())
+	{
+		const Error &e = errors.front();
+		check(e.error_type == ERROR_INVALID_EOF, "stream eof",
+		      "error is not at the end of the input");
+		check((e.start.it.index() == text.size()) &&
+		      (e.finish.it.index() == text.size()), "stream eof",
+		      "error is not at the end of the input");
+	}
+}
+
+/**
+ * Writes `text` to a temporary file, which is deleted when it is closed, and
+ * returns its file descriptor, or -1 on failure.
+ */
+int temporaryFile(const std::string &text)
+{
+	char name[] = "/tmp/pegmatite-test-XXXXXX";
+	int fd = mkstemp(name);
+	if (fd < 0)
+	{
+		perror("mkstemp");
+		return -1;
+	}
+	unlink(name);
+	if (write(fd, text.data(), text.size()) !=
+	    static_cast<ssize_t>(text.size()))
+	{
+		perror("write");
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * Returns `text` split into iovecs of `size` bytes.
+ */
+std::vector<struct iovec> fragments(std::string &text, size_t size)
+{
+	std::vector<struct iovec> iov;
+	for (size_t i=0 ; i<text.size() ; i+=size)
+	{
+		struct iovec v;
+		v.iov_base = &text[i];
+		v.iov_len = std::min(size, text.size() - i);
+		iov.push_back(v);
+	}
+	return iov;
+}
+}
+
+int main()
+{
+	std::string text = words();
+	std::vector<struct iovec> iov = fragments(text, 3);
+	IovecInput reads(iov.data(), static_cast<int>(iov.size()));
+	checkReads("iovec", reads, text);
+	IovecInput parsed(iov.data(), static_cast<int>(iov.size()));
+	checkParse("iovec parse", parsed, text);
+	std::unique_ptr<StreamInput> stream_reads = stream(text);
+	std::unique_ptr<StreamInput> stream_parsed = stream(text);
+	if (stream_reads && stream_parsed)
+	{
+		checkReads("stream", *stream_reads, text);
+		checkParse("stream parse", *stream_parsed, text);
+	}
+	else
+	{
+		check(false, "stream", "no stream");
+	}
+	checkStreamEOF();
+	int fd = temporaryFile(text);
+	if (fd >= 0)
+	{
+		PrefetchFileInput prefetch_reads(fd, 8, 2);
+		checkReads("prefetch", prefetch_reads, text);
+		PrefetchFileInput prefetch_parsed(fd, 8, 2);
+		checkParse("prefetch parse", prefetch_parsed, text);
+		close(fd);
+	}
+	else
+	{
+		check(false, "prefetch", "no file");
+	}
+	return failures ? 1 : 0;
+}